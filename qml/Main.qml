@@ -9,7 +9,8 @@ import "dialogs"
 
 ApplicationWindow {
     id: window
-    visible: true
+    // WindowHost positions and shows the window
+    visible: false
     width: 420
     height: 700
     minimumWidth: 400
@@ -19,11 +20,6 @@ ApplicationWindow {
     title: qsTr("G-Helper Linux")
     color: Theme.background
 
-    function positionBottomRight() {
-        x = Screen.desktopAvailableWidth - width - 12
-        y = Screen.desktopAvailableHeight - height - 52
-    }
-
     onClosing: function(close) {
         if (Settings.minimizeToTray && TrayManager.visible) {
             close.accepted = false
@@ -31,19 +27,6 @@ ApplicationWindow {
         }
     }
 
-    Connections {
-        target: TrayManager
-        function onShowWindowRequested() {
-            positionBottomRight()
-            window.show()
-            window.raise()
-            window.requestActivate()
-        }
-        function onQuitRequested() {
-            Qt.quit()
-        }
-    }
-
     // Header
     header: ToolBar {
         height: 50
@@ -218,6 +201,8 @@ ApplicationWindow {
                         Item { Layout.fillWidth: true }
                         Label {
                             text: "GPU: " + SystemMonitor.gpuTemp + "°C Fan: " + SystemMonitor.gpuFanRpm + "RPM"
+                                  + (SystemMonitor.fanCount > SystemMonitor.MidFan
+                                     ? " Mid: " + SystemMonitor.fanRpms[SystemMonitor.MidFan] + "RPM" : "")
                             font.pixelSize: 13
                             color: Theme.textSecondary
                         }
@@ -305,6 +290,27 @@ ApplicationWindow {
                         }
                     }
 
+                    // Only when asusd exposes more than one Aura device
+                    ComboBox {
+                        Layout.fillWidth: true
+                        visible: AuraController.devices.length > 1
+                        model: ["All devices"].concat(AuraController.devices)
+                        currentIndex: Math.max(0, AuraController.devices.indexOf(AuraController.targetDevice) + 1)
+                        onActivated: AuraController.targetDevice = currentIndex === 0 ? "" : AuraController.devices[currentIndex - 1]
+
+                        background: Rectangle {
+                            color: Theme.buttonBackground
+                            border.color: Theme.border
+                            radius: 4
+                        }
+                        contentItem: Label {
+                            text: parent.displayText
+                            color: Theme.textPrimary
+                            verticalAlignment: Text.AlignVCenter
+                            leftPadding: 8
+                        }
+                    }
+
                     RowLayout {
                         Layout.fillWidth: true
                         spacing: 8
@@ -431,101 +437,108 @@ ApplicationWindow {
             Item {
                 visible: SlashController.available
                 Layout.fillWidth: true
-                Layout.preferredHeight: sectionSlash.implicitHeight + 24
+                Layout.preferredHeight: slashLoader.item ? slashLoader.item.implicitHeight + 24 : 0
                 Layout.leftMargin: 16
                 Layout.rightMargin: 16
                 Layout.topMargin: 16
 
-                ColumnLayout {
-                    id: sectionSlash
+                // Built only on machines that have the lightbar
+                Loader {
+                    id: slashLoader
                     anchors.fill: parent
-                    spacing: 12
-
-                    RowLayout {
-                        Layout.fillWidth: true
-
-                        Image {
-                            source: "qrc:/icons/led-rainbow.svg"
-                            sourceSize: Qt.size(20, 20)
-                        }
-                        Label {
-                            text: "Slash Lightbar"
-                            font.pixelSize: 15
-                            font.bold: true
-                            color: Theme.textPrimary
-                        }
-                        Item { Layout.fillWidth: true }
-                        Switch {
-                            checked: SlashController.enabled
-                            onCheckedChanged: SlashController.setEnabled(checked)
-                        }
-                    }
+                    active: SlashController.available
+                    asynchronous: true
 
-                    RowLayout {
-                        Layout.fillWidth: true
-                        spacing: 8
+                    sourceComponent: ColumnLayout {
+                        id: sectionSlash
+                        spacing: 12
 
-                        ComboBox {
-                            id: slashModeCombo
-                            Layout.preferredWidth: 140
-                            model: SlashController.availableModes
-                            currentIndex: SlashController.availableModes.indexOf(SlashController.currentMode)
-                            onActivated: SlashController.setMode(currentText)
+                        RowLayout {
+                            Layout.fillWidth: true
 
-                            background: Rectangle {
-                                color: Theme.buttonBackground
-                                border.color: Theme.border
-                                radius: 4
+                            Image {
+                                source: "qrc:/icons/led-rainbow.svg"
+                                sourceSize: Qt.size(20, 20)
                             }
-                            contentItem: Label {
-                                text: parent.displayText
+                            Label {
+                                text: "Slash Lightbar"
+                                font.pixelSize: 15
+                                font.bold: true
                                 color: Theme.textPrimary
-                                verticalAlignment: Text.AlignVCenter
-                                leftPadding: 8
+                            }
+                            Item { Layout.fillWidth: true }
+                            Switch {
+                                checked: SlashController.enabled
+                                onCheckedChanged: SlashController.setEnabled(checked)
                             }
                         }
 
-                        Label {
-                            text: "Brightness"
-                            color: Theme.textSecondary
-                            font.pixelSize: 12
-                        }
-
-                        Slider {
+                        RowLayout {
                             Layout.fillWidth: true
-                            from: 0
-                            to: 255
-                            stepSize: 1
-                            value: SlashController.brightness
-                            onPressedChanged: {
-                                if (!pressed) {
-                                    SlashController.setBrightness(Math.round(value))
+                            spacing: 8
+
+                            ComboBox {
+                                id: slashModeCombo
+                                Layout.preferredWidth: 140
+                                model: SlashController.availableModes
+                                currentIndex: SlashController.availableModes.indexOf(SlashController.currentMode)
+                                onActivated: SlashController.setMode(currentText)
+
+                                background: Rectangle {
+                                    color: Theme.buttonBackground
+                                    border.color: Theme.border
+                                    radius: 4
+                                }
+                                contentItem: Label {
+                                    text: parent.displayText
+                                    color: Theme.textPrimary
+                                    verticalAlignment: Text.AlignVCenter
+                                    leftPadding: 8
                                 }
                             }
 
-                            background: Rectangle {
-                                x: parent.leftPadding
-                                y: parent.topPadding + parent.availableHeight / 2 - height / 2
-                                width: parent.availableWidth
-                                height: 4
-                                radius: 2
-                                color: Theme.border
+                            Label {
+                                text: "Brightness"
+                                color: Theme.textSecondary
+                                font.pixelSize: 12
+                            }
 
-                                Rectangle {
-                                    width: parent.parent.visualPosition * parent.width
-                                    height: parent.height
-                                    color: Theme.accent
+                            Slider {
+                                Layout.fillWidth: true
+                                from: 0
+                                to: 255
+                                stepSize: 1
+                                value: SlashController.brightness
+                                onPressedChanged: {
+                                    if (!pressed) {
+                                        SlashController.setBrightness(Math.round(value))
+                                    }
+                                }
+
+                                background: Rectangle {
+                                    x: parent.leftPadding
+                                    y: parent.topPadding + parent.availableHeight / 2 - height / 2
+                                    width: parent.availableWidth
+                                    height: 4
                                     radius: 2
+                                    color: Theme.border
+
+                                    Rectangle {
+                                        width: parent.parent.visualPosition * parent.width
+                                        height: parent.height
+                                        color: Theme.accent
+                                        radius: 2
+                                    }
                                 }
-                            }
 
-                            handle: Rectangle {
-                                x: parent.leftPadding + parent.visualPosition * (parent.availableWidth - width)
-                                y: parent.topPadding + parent.availableHeight / 2 - height / 2
-                                width: 16
-                                height: 16
-                                radius: 8
-                                color: Theme.accent
+                                handle: Rectangle {
+                                    x: parent.leftPadding + parent.visualPosition * (parent.availableWidth - width)
+                                    y: parent.topPadding + parent.availableHeight / 2 - height / 2
+                                    width: 16
+                                    height: 16
+                                    radius: 8
+                                    color: Theme.accent
+                                }
                             }
                         }
                     }
@@ -733,65 +746,79 @@ ApplicationWindow {
         }
     }
 
-    // Dialogs
-    AboutDialog {
+    // Dialogs and popups below are built the first time they are opened
+    OnDemand {
         id: aboutDialog
-        anchors.centerIn: parent
+        sourceComponent: AboutDialog {
+            parent: Overlay.overlay
+            anchors.centerIn: parent
+        }
+    }
+
+    // Hidden diagnostics page
+    OnDemand {
+        id: diagnosticsDialog
+        sourceComponent: DiagnosticsDialog {
+            parent: Overlay.overlay
+            anchors.centerIn: parent
+        }
+    }
+
+    Shortcut {
+        sequence: "Ctrl+Shift+D"
+        onActivated: diagnosticsDialog.open()
     }
 
     // Fan Curve Window (separate window)
-    Loader {
-        id: fanCurveLoader
-        active: false
+    OnDemand {
+        id: fanCurveDialog
         sourceComponent: FanCurveDialog {}
     }
 
     function openFanCurveWindow() {
-        if (!fanCurveLoader.active) {
-            fanCurveLoader.active = true
-        }
-        if (fanCurveLoader.item) {
-            fanCurveLoader.item.open(window.x, window.y)
-        }
+        fanCurveDialog.open(window.x, window.y)
     }
 
     // Color picker dialog (simplified)
-    Dialog {
+    OnDemand {
         id: colorDialog
-        title: "Select Color"
-        anchors.centerIn: parent
-        modal: true
-
-        background: Rectangle {
-            color: Theme.surface
-            border.color: Theme.border
-            radius: 8
-        }
+        sourceComponent: Dialog {
+            parent: Overlay.overlay
+            title: "Select Color"
+            anchors.centerIn: parent
+            modal: true
+
+            background: Rectangle {
+                color: Theme.surface
+                border.color: Theme.border
+                radius: 8
+            }
 
-        GridLayout {
-            columns: 6
-            rowSpacing: 8
-            columnSpacing: 8
-
-            Repeater {
-                model: [
-                    "#ff0000", "#ff8000", "#ffff00", "#80ff00", "#00ff00", "#00ff80",
-                    "#00ffff", "#0080ff", "#0000ff", "#8000ff", "#ff00ff", "#ff0080",
-                    "#ffffff", "#c0c0c0", "#808080", "#404040", "#000000", "#804000"
-                ]
-
-                delegate: Rectangle {
-                    width: 32
-                    height: 32
-                    color: modelData
-                    border.color: Theme.border
-                    radius: 4
-
-                    MouseArea {
-                        anchors.fill: parent
-                        onClicked: {
-                            AuraController.setColor1(modelData)
-                            colorDialog.close()
+            GridLayout {
+                columns: 6
+                rowSpacing: 8
+                columnSpacing: 8
+
+                Repeater {
+                    model: [
+                        "#ff0000", "#ff8000", "#ffff00", "#80ff00", "#00ff00", "#00ff80",
+                        "#00ffff", "#0080ff", "#0000ff", "#8000ff", "#ff00ff", "#ff0080",
+                        "#ffffff", "#c0c0c0", "#808080", "#404040", "#000000", "#804000"
+                    ]
+
+                    delegate: Rectangle {
+                        width: 32
+                        height: 32
+                        color: modelData
+                        border.color: Theme.border
+                        radius: 4
+
+                        MouseArea {
+                            anchors.fill: parent
+                            onClicked: {
+                                AuraController.setColor1(modelData)
+                                colorDialog.close()
+                            }
                         }
                     }
                 }
@@ -800,108 +827,195 @@ ApplicationWindow {
     }
 
     // Settings popup
-    Popup {
+    OnDemand {
         id: settingsPopup
-        x: parent.width - width - 16
-        y: 60
-        width: 250
-        padding: 16
+        sourceComponent: Popup {
+            parent: Overlay.overlay
+            x: parent.width - width - 16
+            y: 60
+            width: 250
+            padding: 16
+
+            background: Rectangle {
+                color: Theme.surface
+                border.color: Theme.border
+                radius: 8
+            }
 
-        background: Rectangle {
-            color: Theme.surface
-            border.color: Theme.border
-            radius: 8
-        }
+            ColumnLayout {
+                anchors.fill: parent
+                spacing: 8
 
-        ColumnLayout {
-            anchors.fill: parent
-            spacing: 8
+                Label {
+                    text: "Settings"
+                    font.pixelSize: 16
+                    font.bold: true
+                    color: Theme.textPrimary
+                }
 
-            Label {
-                text: "Settings"
-                font.pixelSize: 16
-                font.bold: true
-                color: Theme.textPrimary
-            }
+                Rectangle {
+                    Layout.fillWidth: true
+                    height: 1
+                    color: Theme.border
+                }
 
-            Rectangle {
-                Layout.fillWidth: true
-                height: 1
-                color: Theme.border
-            }
+                CheckBox {
+                    text: "Start minimized"
+                    checked: Settings.startMinimized
+                    onCheckedChanged: Settings.startMinimized = checked
+                    contentItem: Label {
+                        text: parent.text
+                        color: Theme.textPrimary
+                        leftPadding: parent.indicator.width + 8
+                    }
+                }
 
-            CheckBox {
-                text: "Start minimized"
-                checked: Settings.startMinimized
-                onCheckedChanged: Settings.startMinimized = checked
-                contentItem: Label {
-                    text: parent.text
-                    color: Theme.textPrimary
-                    leftPadding: parent.indicator.width + 8
+                CheckBox {
+                    text: "Start with system"
+                    checked: Settings.autoStart
+                    onCheckedChanged: Settings.autoStart = checked
+                    contentItem: Label {
+                        text: parent.text
+                        color: Theme.textPrimary
+                        leftPadding: parent.indicator.width + 8
+                    }
                 }
-            }
 
-            CheckBox {
-                text: "Start with system"
-                checked: Settings.autoStart
-                onCheckedChanged: Settings.autoStart = checked
-                contentItem: Label {
-                    text: parent.text
-                    color: Theme.textPrimary
-                    leftPadding: parent.indicator.width + 8
+                CheckBox {
+                    text: "Minimize to tray"
+                    checked: Settings.minimizeToTray
+                    onCheckedChanged: Settings.minimizeToTray = checked
+                    contentItem: Label {
+                        text: parent.text
+                        color: Theme.textPrimary
+                        leftPadding: parent.indicator.width + 8
+                    }
                 }
-            }
 
-            CheckBox {
-                text: "Minimize to tray"
-                checked: Settings.minimizeToTray
-                onCheckedChanged: Settings.minimizeToTray = checked
-                contentItem: Label {
-                    text: parent.text
-                    color: Theme.textPrimary
-                    leftPadding: parent.indicator.width + 8
+                RowLayout {
+                    Layout.fillWidth: true
+
+                    Label {
+                        text: "Tray icon"
+                        color: Theme.textPrimary
+                        Layout.fillWidth: true
+                    }
+
+                    ComboBox {
+                        model: ["Logo", "CPU temperature", "Power draw"]
+                        currentIndex: Settings.trayIconContent
+                        onActivated: Settings.trayIconContent = currentIndex
+
+                        background: Rectangle {
+                            color: Theme.buttonBackground
+                            border.color: Theme.border
+                            radius: 4
+                        }
+                        contentItem: Label {
+                            text: parent.displayText
+                            color: Theme.textPrimary
+                            verticalAlignment: Text.AlignVCenter
+                            leftPadding: 8
+                        }
+                    }
+                }
+
+                RowLayout {
+                    Layout.fillWidth: true
+                    visible: Settings.minimizeToTray
+
+                    Label {
+                        text: "Unload UI when hidden (s)"
+                        color: Theme.textPrimary
+                        Layout.fillWidth: true
+                    }
+
+                    SpinBox {
+                        from: 0
+                        to: 3600
+                        stepSize: 30
+                        editable: true
+                        value: Settings.uiUnloadDelay
+                        onValueModified: Settings.uiUnloadDelay = value
+                    }
+                }
+
+                Rectangle {
+                    Layout.fillWidth: true
+                    height: 1
+                    color: Theme.border
+                }
+
+                RowLayout {
+                    Layout.fillWidth: true
+
+                    Label {
+                        text: "Fan RPM limit"
+                        color: Theme.textPrimary
+                        Layout.fillWidth: true
+                    }
+
+                    SpinBox {
+                        from: 0
+                        to: 8000
+                        stepSize: 100
+                        editable: true
+                        value: Settings.fanRpmLimit
+                        onValueModified: Settings.fanRpmLimit = value
+                    }
+                }
+
+                Label {
+                    text: Settings.fanRpmLimit > 0
+                          ? (AcousticGovernor.clamped ? "Limiting fans" : "Within limit")
+                          : "0 = off"
+                    color: Theme.textSecondary
+                    font.pixelSize: 11
                 }
             }
         }
     }
 
-    Popup {
+    OnDemand {
         id: keyboardExtraPopup
-        anchors.centerIn: parent
-        width: 200
-        padding: 16
-
-        background: Rectangle {
-            color: Theme.surface
-            border.color: Theme.border
-            radius: 8
-        }
-
-        ColumnLayout {
-            anchors.fill: parent
-            spacing: 8
-
-            Label {
-                text: "Keyboard Settings"
-                font.bold: true
-                color: Theme.textPrimary
+        sourceComponent: Popup {
+            parent: Overlay.overlay
+            anchors.centerIn: parent
+            width: 200
+            padding: 16
+
+            background: Rectangle {
+                color: Theme.surface
+                border.color: Theme.border
+                radius: 8
             }
 
-            CheckBox {
-                text: "Disable on battery"
-                contentItem: Label {
-                    text: parent.text
+            ColumnLayout {
+                anchors.fill: parent
+                spacing: 8
+
+                Label {
+                    text: "Keyboard Settings"
+                    font.bold: true
                     color: Theme.textPrimary
-                    leftPadding: parent.indicator.width + 8
                 }
-            }
 
-            CheckBox {
-                text: "Disable on lid close"
-                contentItem: Label {
-                    text: parent.text
-                    color: Theme.textPrimary
-                    leftPadding: parent.indicator.width + 8
+                CheckBox {
+                    text: "Disable on battery"
+                    contentItem: Label {
+                        text: parent.text
+                        color: Theme.textPrimary
+                        leftPadding: parent.indicator.width + 8
+                    }
+                }
+
+                CheckBox {
+                    text: "Disable on lid close"
+                    contentItem: Label {
+                        text: parent.text
+                        color: Theme.textPrimary
+                        leftPadding: parent.indicator.width + 8
+                    }
                 }
             }
         }
@@ -0,0 +1,37 @@
+import QtQuick
+
+// Holds a popup or dialog that is only built the first time it is opened.
+// Creation is asynchronous, so opening never stalls a frame; open() called
+// while it is still loading opens it as soon as it is ready. Arguments to
+// open() are passed on to the item's own open().
+Loader {
+    id: root
+    active: false
+    asynchronous: true
+
+    property bool openPending: false
+    property var openArgs: []
+
+    function open() {
+        openArgs = Array.prototype.slice.call(arguments)
+        if (item) {
+            item.open.apply(item, openArgs)
+            return
+        }
+        openPending = true
+        active = true
+    }
+
+    function close() {
+        openPending = false
+        if (item)
+            item.close()
+    }
+
+    onLoaded: {
+        if (openPending) {
+            openPending = false
+            item.open.apply(item, openArgs)
+        }
+    }
+}
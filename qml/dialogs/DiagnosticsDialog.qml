@@ -0,0 +1,120 @@
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import GHelperLinux
+import "../theme"
+
+// Hidden page (Ctrl+Shift+D): D-Bus call latency per operation
+Dialog {
+    id: root
+    title: qsTr("Diagnostics")
+    modal: true
+    width: 420
+    height: 360
+
+    property var rows: []
+
+    function reload() {
+        rows = LatencyStats.snapshot()
+    }
+
+    onOpened: reload()
+
+    Timer {
+        interval: 1000
+        running: root.visible
+        repeat: true
+        onTriggered: root.reload()
+    }
+
+    background: Rectangle {
+        color: Theme.background
+        border.color: Theme.border
+        radius: Theme.radiusMedium
+    }
+
+    header: Rectangle {
+        color: Theme.surface
+        height: 50
+        radius: Theme.radiusMedium
+
+        Text {
+            anchors.centerIn: parent
+            text: root.title
+            font.pixelSize: Theme.fontSizeLarge
+            font.bold: true
+            color: Theme.textPrimary
+        }
+    }
+
+    contentItem: ColumnLayout {
+        spacing: Theme.spacingSmall
+
+        Text {
+            text: qsTr("D-Bus latency (µs)")
+            font.pixelSize: Theme.fontSizeMedium
+            font.bold: true
+            color: Theme.textPrimary
+        }
+
+        GridLayout {
+            Layout.fillWidth: true
+            columns: 7
+            columnSpacing: Theme.spacingSmall
+            rowSpacing: Theme.spacingTiny
+
+            Repeater {
+                model: [qsTr("Operation"), qsTr("Calls"), qsTr("Err"), "p50", "p90", "p99", qsTr("Max")]
+                Text {
+                    text: modelData
+                    font.pixelSize: Theme.fontSizeSmall
+                    font.bold: true
+                    color: Theme.textSecondary
+                    Layout.fillWidth: index === 0
+                }
+            }
+
+            Repeater {
+                model: root.rows
+                delegate: Repeater {
+                    property var row: modelData
+                    model: [row.name, row.count, row.errors, row.p50, row.p90, row.p99, row.max]
+                    Text {
+                        text: modelData
+                        font.pixelSize: Theme.fontSizeSmall
+                        color: index === 2 && modelData > 0 ? Theme.error : Theme.textPrimary
+                        Layout.fillWidth: index === 0
+                    }
+                }
+            }
+        }
+
+        Text {
+            visible: root.rows.length === 0
+            text: qsTr("No D-Bus calls recorded yet")
+            font.pixelSize: Theme.fontSizeSmall
+            color: Theme.textSecondary
+        }
+
+        Item { Layout.fillHeight: true }
+    }
+
+    footer: DialogButtonBox {
+        background: Rectangle {
+            color: Theme.surface
+        }
+
+        Button {
+            text: qsTr("Reset")
+            onClicked: {
+                LatencyStats.reset()
+                root.reload()
+            }
+        }
+
+        Button {
+            text: qsTr("Close")
+            DialogButtonBox.buttonRole: DialogButtonBox.AcceptRole
+        }
+    }
+}
@@ -179,6 +179,35 @@ Window {
             }
         }
 
+        // Mid (system) fan section - only on models with a third fan
+        RowLayout {
+            Layout.fillWidth: true
+            visible: FanController.fanCount > FanController.MidFan
+            Text {
+                text: qsTr("Mid Fan")
+                font.pixelSize: Theme.fontSizeMedium
+                font.bold: true
+                color: Theme.balancedColor
+            }
+            Item { Layout.fillWidth: true }
+        }
+
+        FanCurveCanvas {
+            id: midCanvas
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            Layout.preferredHeight: 250
+            visible: FanController.fanCount > FanController.MidFan
+            curveData: visible ? FanController.curves[FanController.MidFan] : []
+            curveColor: root.profileColor(root.selectedProfile)
+            label: "MID"
+
+            onCurveChanged: function(newCurve) {
+                FanController.setCurve(FanController.MidFan, newCurve,
+                                       FanController.curvesEnabled[FanController.MidFan])
+            }
+        }
+
         // Bottom buttons
         RowLayout {
             Layout.fillWidth: true
@@ -190,6 +219,7 @@ Window {
                     FanController.resetCurrentProfileToDefaults()
                     cpuCanvas.reloadFromExternal()
                     gpuCanvas.reloadFromExternal()
+                    midCanvas.reloadFromExternal()
                 }
 
                 background: Rectangle {
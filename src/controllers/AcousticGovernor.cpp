@@ -0,0 +1,186 @@
+#include "AcousticGovernor.h"
+#include "SystemMonitor.h"
+#include "PerformanceController.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+
+AcousticGovernor::AcousticGovernor(SystemMonitor *monitor,
+                                   PerformanceController *perfController,
+                                   QObject *parent)
+    : QObject(parent)
+    , m_monitor(monitor)
+    , m_perfController(perfController)
+{
+    connect(m_monitor, &SystemMonitor::sampled,
+            this, &AcousticGovernor::onSampled);
+    connect(m_perfController, &PerformanceController::currentProfileChanged,
+            this, &AcousticGovernor::onProfileChanged);
+}
+
+AcousticGovernor::~AcousticGovernor() = default;
+
+void AcousticGovernor::setRpmLimit(int rpm)
+{
+    rpm = qMax(0, rpm);
+    if (m_rpmLimit != rpm) {
+        m_rpmLimit = rpm;
+        m_overSamples = 0;
+        m_underSamples = 0;
+        m_atFloorLogged = false;
+        emit rpmLimitChanged(rpm);
+    }
+}
+
+void AcousticGovernor::onSampled()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    int rpm = 0;
+    for (int fanRpm : m_monitor->fanRpms()) {
+        rpm = qMax(rpm, fanRpm);
+    }
+    // Act on where the temperature is heading, not just where it is
+    const int temp = qMax(m_monitor->cpuTemp(), m_monitor->predictedCpuTemp());
+    const int profile = m_perfController->currentProfile();
+
+    // Budget switched off: hand the user's profile back
+    if (m_rpmLimit <= 0) {
+        if (m_clamped) {
+            applyProfile(m_userProfile);
+            setClamped(false);
+            log(Released, profile, m_userProfile, rpm, temp, timer.nsecsElapsed());
+        }
+        return;
+    }
+
+    // Thermals win over acoustics
+    if (m_clamped && temp >= CRITICAL_TEMP) {
+        applyProfile(m_userProfile);
+        setClamped(false);
+        m_overSamples = 0;
+        m_underSamples = 0;
+        log(ThermalOverride, profile, m_userProfile, rpm, temp, timer.nsecsElapsed());
+        return;
+    }
+
+    if (rpm > m_rpmLimit) {
+        m_overSamples++;
+        m_underSamples = 0;
+    } else if (rpm < m_rpmLimit * RELEASE_RATIO) {
+        m_underSamples++;
+        m_overSamples = 0;
+    } else {
+        // Inside the hysteresis band: hold the current state
+        m_overSamples = 0;
+        m_underSamples = 0;
+    }
+
+    if (m_overSamples >= ENGAGE_SAMPLES && temp < CRITICAL_TEMP) {
+        m_overSamples = 0;
+        if (profile <= PerformanceController::Quiet) {
+            if (!m_atFloorLogged) {
+                m_atFloorLogged = true;
+                log(AtFloor, profile, profile, rpm, temp, timer.nsecsElapsed());
+            }
+            return;
+        }
+
+        if (!m_clamped) {
+            m_userProfile = profile;
+            setClamped(true);
+        }
+        applyProfile(profile - 1);
+        log(StepDown, profile, profile - 1, rpm, temp, timer.nsecsElapsed());
+        return;
+    }
+
+    if (m_clamped && m_underSamples >= RELEASE_SAMPLES) {
+        m_underSamples = 0;
+        m_atFloorLogged = false;
+
+        const int next = qMin(profile + 1, m_userProfile);
+        applyProfile(next);
+        if (next >= m_userProfile) {
+            setClamped(false);
+            log(Released, profile, next, rpm, temp, timer.nsecsElapsed());
+        } else {
+            log(StepUp, profile, next, rpm, temp, timer.nsecsElapsed());
+        }
+    }
+}
+
+void AcousticGovernor::onProfileChanged(int profile)
+{
+    if (profile == m_expectedProfile) {
+        // Our own change coming back; anything after it is someone else's
+        m_expectedProfile = -1;
+        return;
+    }
+    if (!m_clamped) return;
+
+    // The user (or the Fn key) picked a profile while we were clamping;
+    // respect it as the new baseline instead of fighting it
+    log(UserOverride, m_heldProfile, profile, 0, m_monitor->cpuTemp(), 0);
+    m_userProfile = profile;
+    setClamped(false);
+    m_overSamples = 0;
+    m_underSamples = 0;
+}
+
+void AcousticGovernor::applyProfile(int profile)
+{
+    if (profile < 0 || profile == m_perfController->currentProfile()) return;
+
+    m_heldProfile = profile;
+    m_expectedProfile = profile;
+    m_perfController->setProfile(profile);
+}
+
+void AcousticGovernor::setClamped(bool clamped)
+{
+    if (m_clamped != clamped) {
+        m_clamped = clamped;
+        if (!clamped) {
+            // Whatever echo is still on its way, a released clamp owns nothing
+            m_expectedProfile = -1;
+        }
+        qDebug() << "AcousticGovernor:" << (clamped ? "clamping" : "released")
+                 << "limit" << m_rpmLimit << "RPM";
+        emit clampedChanged(clamped);
+    }
+}
+
+void AcousticGovernor::log(Action action, int from, int to, int rpm, int temp, qint64 nsecs)
+{
+    Decision &entry = m_log[m_logHead];
+    entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+    entry.nsecs = nsecs;
+    entry.rpm = rpm;
+    entry.temp = temp;
+    entry.action = static_cast<quint8>(action);
+    entry.fromProfile = static_cast<qint8>(from);
+    entry.toProfile = static_cast<qint8>(to);
+
+    m_logHead = (m_logHead + 1) % LOG_SIZE;
+    m_logCount = qMin(m_logCount + 1, LOG_SIZE);
+}
+
+QVariantList AcousticGovernor::decisionLog() const
+{
+    QVariantList result;
+    for (int i = 0; i < m_logCount; i++) {
+        const Decision &entry = m_log[(m_logHead - 1 - i + LOG_SIZE) % LOG_SIZE];
+        result.append(QVariantMap{
+            {"time", QDateTime::fromMSecsSinceEpoch(entry.timestamp)},
+            {"action", entry.action},
+            {"from", entry.fromProfile},
+            {"to", entry.toProfile},
+            {"rpm", entry.rpm},
+            {"temp", entry.temp},
+            {"nsecs", entry.nsecs}
+        });
+    }
+    return result;
+}
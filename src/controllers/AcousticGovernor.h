@@ -0,0 +1,89 @@
+#ifndef ACOUSTICGOVERNOR_H
+#define ACOUSTICGOVERNOR_H
+
+#include <QObject>
+#include <QVariantList>
+
+class SystemMonitor;
+class PerformanceController;
+
+// Keeps fan speed under an RPM budget by stepping the performance profile
+// down while any fan is over the limit, and back up (with hysteresis) once
+// the fans have settled. Decisions are taken on SystemMonitor's sampling
+// tick and recorded in a fixed-size ring buffer.
+class AcousticGovernor : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int rpmLimit READ rpmLimit WRITE setRpmLimit NOTIFY rpmLimitChanged)
+    Q_PROPERTY(bool clamped READ isClamped NOTIFY clampedChanged)
+
+public:
+    enum Action {
+        StepDown = 0,
+        StepUp = 1,
+        Released = 2,
+        ThermalOverride = 3,
+        UserOverride = 4,
+        AtFloor = 5
+    };
+    Q_ENUM(Action)
+
+    explicit AcousticGovernor(SystemMonitor *monitor,
+                              PerformanceController *perfController,
+                              QObject *parent = nullptr);
+    ~AcousticGovernor() override;
+
+    int rpmLimit() const { return m_rpmLimit; }
+    void setRpmLimit(int rpm);
+    bool isClamped() const { return m_clamped; }
+
+    // Newest first; each entry has time, action, from, to, rpm, temp, nsecs
+    Q_INVOKABLE QVariantList decisionLog() const;
+
+signals:
+    void rpmLimitChanged(int rpm);
+    void clampedChanged(bool clamped);
+
+private slots:
+    void onSampled();
+    void onProfileChanged(int profile);
+
+private:
+    struct Decision {
+        qint64 timestamp;
+        qint64 nsecs;
+        int rpm;
+        int temp;
+        quint8 action;
+        qint8 fromProfile;
+        qint8 toProfile;
+    };
+
+    void applyProfile(int profile);
+    void setClamped(bool clamped);
+    void log(Action action, int from, int to, int rpm, int temp, qint64 nsecs);
+
+    SystemMonitor *m_monitor;
+    PerformanceController *m_perfController;
+
+    int m_rpmLimit = 0;
+    bool m_clamped = false;
+    bool m_atFloorLogged = false;
+    int m_userProfile = -1;     // Profile to return to once released
+    int m_heldProfile = -1;     // Profile the clamp last set
+    int m_expectedProfile = -1; // Set by us, echo not seen yet
+    int m_overSamples = 0;
+    int m_underSamples = 0;
+
+    static constexpr int LOG_SIZE = 64;
+    Decision m_log[LOG_SIZE];
+    int m_logHead = 0;
+    int m_logCount = 0;
+
+    static constexpr int ENGAGE_SAMPLES = 3;        // Over budget this long before stepping down
+    static constexpr int RELEASE_SAMPLES = 10;      // Under budget this long before stepping up
+    static constexpr double RELEASE_RATIO = 0.85;   // "Under budget" means below 85% of the limit
+    static constexpr int CRITICAL_TEMP = 95;        // Never hold a clamp past this
+};
+
+#endif // ACOUSTICGOVERNOR_H
@@ -1,9 +1,22 @@
 #include "AuraController.h"
 #include "AsusdClient.h"
+#include "Trace.h"
 #include <QProcess>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QRegularExpression>
 
+namespace {
+
+AuraColor toAuraColor(const QColor &color)
+{
+    return {static_cast<quint8>(color.red()),
+            static_cast<quint8>(color.green()),
+            static_cast<quint8>(color.blue())};
+}
+
+} // namespace
+
 AuraController::AuraController(AsusdClient *client, QObject *parent)
     : QObject(parent)
     , m_client(client)
@@ -14,6 +27,13 @@ AuraController::AuraController(AsusdClient *client, QObject *parent)
             this, &AuraController::onClientConnected);
     connect(m_client, &AsusdClient::errorOccurred,
             this, &AuraController::errorOccurred);
+    connect(m_client, &AsusdClient::auraDevicesChanged, this, [this]() {
+        // A target that was unplugged falls back to all devices
+        if (!m_targetDevice.isEmpty() && !m_client->auraDevices().contains(m_targetDevice)) {
+            setTargetDevice(QString());
+        }
+        emit devicesChanged();
+    });
 
     initAvailableModes();
 
@@ -26,12 +46,34 @@ AuraController::AuraController(AsusdClient *client, QObject *parent)
 
 void AuraController::fetchCurrentState()
 {
-    // Read current LED state from asusctl
-    QProcess process;
-    process.start("asusctl", QStringList{"led-mode", "-c"});
-    process.waitForFinished(3000);
+    if (m_stateProbe) return;
+
+    // Read current LED state from asusctl without holding up the UI
+    m_stateProbe = new QProcess(this);
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 traceStart = Trace::now();
 
-    QString output = QString::fromUtf8(process.readAllStandardOutput());
+    connect(m_stateProbe, &QProcess::finished, this, [this, timer, traceStart]() {
+        qDebug() << "AuraController: State probe finished in" << timer.elapsed() << "ms";
+        Trace::complete("asusctl led-mode -c", "probe", traceStart, Trace::now());
+        parseLedState(QString::fromUtf8(m_stateProbe->readAllStandardOutput()));
+        m_stateProbe->deleteLater();
+        m_stateProbe = nullptr;
+    });
+    connect(m_stateProbe, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            qWarning() << "AuraController: asusctl not available";
+            m_stateProbe->deleteLater();
+            m_stateProbe = nullptr;
+        }
+    });
+
+    m_stateProbe->start("asusctl", QStringList{"led-mode", "-c"});
+}
+
+void AuraController::parseLedState(const QString &output)
+{
     qDebug() << "AuraController: Current LED state:" << output;
 
     // Parse output to get current mode and colors
@@ -103,7 +145,7 @@ void AuraController::setBrightness(int level)
         return;
     }
 
-    m_client->setLedBrightness(static_cast<quint32>(level));
+    m_client->setLedBrightness(static_cast<quint32>(level), m_targetDevice);
 }
 
 void AuraController::setMode(int mode)
@@ -150,7 +192,21 @@ void AuraController::applyEffect()
         return;
     }
 
-    m_client->setLedMode(static_cast<quint32>(m_currentMode), m_color1, m_color2, static_cast<quint8>(m_speed));
+    m_client->setLedMode(static_cast<quint32>(m_currentMode), toAuraColor(m_color1), toAuraColor(m_color2),
+                         static_cast<quint8>(m_speed), m_targetDevice);
+}
+
+QStringList AuraController::devices() const
+{
+    return m_client->auraDevices();
+}
+
+void AuraController::setTargetDevice(const QString &device)
+{
+    if (m_targetDevice != device) {
+        m_targetDevice = device;
+        emit targetDeviceChanged(device);
+    }
 }
 
 void AuraController::refresh()
@@ -216,6 +272,7 @@ void AuraController::onClientConnected(bool connected)
         if (connected) {
             m_brightness = static_cast<int>(m_client->ledBrightness());
             emit brightnessChanged(m_brightness);
+            fetchCurrentState();
         }
     }
 }
@@ -4,8 +4,10 @@
 #include <QObject>
 #include <QColor>
 #include <QVariantList>
+#include <QStringList>
 
 class AsusdClient;
+class QProcess;
 
 class AuraController : public QObject
 {
@@ -17,6 +19,8 @@ class AuraController : public QObject
     Q_PROPERTY(int speed READ speed NOTIFY speedChanged)
     Q_PROPERTY(QVariantList availableModes READ availableModes CONSTANT)
     Q_PROPERTY(bool available READ isAvailable NOTIFY availableChanged)
+    Q_PROPERTY(QStringList devices READ devices NOTIFY devicesChanged)
+    Q_PROPERTY(QString targetDevice READ targetDevice WRITE setTargetDevice NOTIFY targetDeviceChanged)
 
 public:
     enum Mode {
@@ -54,6 +58,10 @@ public:
     int speed() const { return m_speed; }
     QVariantList availableModes() const { return m_availableModes; }
     bool isAvailable() const { return m_available; }
+    QStringList devices() const;
+    // Empty applies brightness and effects to every Aura device
+    QString targetDevice() const { return m_targetDevice; }
+    void setTargetDevice(const QString &device);
 
     Q_INVOKABLE void setBrightness(int level);
     Q_INVOKABLE void setMode(int mode);
@@ -74,6 +82,8 @@ signals:
     void colorsChanged();
     void speedChanged(int speed);
     void availableChanged(bool available);
+    void devicesChanged();
+    void targetDeviceChanged(const QString &device);
     void errorOccurred(const QString &error);
 
 private slots:
@@ -83,8 +93,10 @@ private slots:
 private:
     void initAvailableModes();
     void fetchCurrentState();
+    void parseLedState(const QString &output);
 
     AsusdClient *m_client;
+    QProcess *m_stateProbe = nullptr; // asusctl led-mode -c, while running
 
     int m_brightness = BrightnessMedium;
     int m_currentMode = Static;
@@ -93,6 +105,7 @@ private:
     int m_speed = 1;
     QVariantList m_availableModes;
     bool m_available = false;
+    QString m_targetDevice;
 };
 
 #endif // AURACONTROLLER_H
@@ -3,11 +3,11 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QSettings>
 
 FanController::FanController(AsusdClient *client, QObject *parent)
     : QObject(parent)
     , m_client(client)
-    , m_settings("g-helper-linux", "fan-curves")
 {
     connect(m_client, &AsusdClient::fanCurvesChanged,
             this, &FanController::onFanCurvesChanged);
@@ -21,11 +21,11 @@ FanController::FanController(AsusdClient *client, QObject *parent)
     // Initialize with defaults first
     initializeDefaultCurves();
 
-    // Try to load from settings
-    loadFromSettings();
+    // Overlay anything the user saved
+    loadFromStore();
 
     m_available = m_client->isConnected();
-    if (m_available) {
+    if (m_available && static_cast<int>(m_client->platformProfile()) < PROFILE_COUNT) {
         m_currentProfile = static_cast<int>(m_client->platformProfile());
     }
 }
@@ -34,132 +34,169 @@ FanController::~FanController() = default;
 
 void FanController::initializeDefaultCurves()
 {
-    for (int profile = 0; profile < 3; profile++) {
-        m_cpuCurves[profile] = defaultCurve(profile);
-        m_gpuCurves[profile] = defaultCurve(profile);
+    for (int profile = 0; profile < PROFILE_COUNT; profile++) {
+        for (int fan = 0; fan < MAX_FANS; fan++) {
+            m_curves[profile][fan] = defaultCurve(profile);
+            m_curveEnabled[profile][fan] = true;
+        }
     }
 }
 
-void FanController::loadFromSettings()
+void FanController::loadFromStore()
 {
-    for (int profile = 0; profile < 3; profile++) {
-        QString cpuKey = QString("profile%1/cpu").arg(profile);
-        QString gpuKey = QString("profile%1/gpu").arg(profile);
-
-        if (m_settings.contains(cpuKey)) {
-            QByteArray cpuData = m_settings.value(cpuKey).toByteArray();
-            QJsonDocument doc = QJsonDocument::fromJson(cpuData);
-            if (doc.isArray()) {
-                QVariantList curve;
-                QJsonArray arr = doc.array();
-                for (const auto &item : arr) {
-                    QJsonObject obj = item.toObject();
-                    curve.append(QVariantMap{
-                        {"temp", obj["temp"].toInt()},
-                        {"fan", obj["fan"].toInt()}
-                    });
-                }
-                if (!curve.isEmpty()) {
-                    m_cpuCurves[profile] = curve;
-                }
-            }
+    if (m_store.load()) {
+        pullFromStore();
+        return;
+    }
+
+    // First run with the binary store: carry over curves saved by older versions
+    migrateFromSettings();
+    for (int profile = 0; profile < PROFILE_COUNT; profile++) {
+        for (int fan = 0; fan < MAX_FANS; fan++) {
+            m_store.setCurve(profile, fan, m_curves[profile][fan], m_curveEnabled[profile][fan]);
         }
+    }
+    m_store.flush();
+}
 
-        if (m_settings.contains(gpuKey)) {
-            QByteArray gpuData = m_settings.value(gpuKey).toByteArray();
-            QJsonDocument doc = QJsonDocument::fromJson(gpuData);
-            if (doc.isArray()) {
-                QVariantList curve;
-                QJsonArray arr = doc.array();
-                for (const auto &item : arr) {
-                    QJsonObject obj = item.toObject();
-                    curve.append(QVariantMap{
-                        {"temp", obj["temp"].toInt()},
-                        {"fan", obj["fan"].toInt()}
-                    });
-                }
-                if (!curve.isEmpty()) {
-                    m_gpuCurves[profile] = curve;
-                }
+void FanController::pullFromStore()
+{
+    for (int profile = 0; profile < PROFILE_COUNT; profile++) {
+        for (int fan = 0; fan < MAX_FANS; fan++) {
+            if (!m_store.contains(profile, fan)) continue;
+
+            QVariantList curve = m_store.curve(profile, fan);
+            if (!curve.isEmpty()) {
+                m_curves[profile][fan] = curve;
             }
+            m_curveEnabled[profile][fan] = m_store.isEnabled(profile, fan);
         }
     }
-    qDebug() << "FanController: Loaded curves from settings";
+    qDebug() << "FanController: Loaded curves from" << m_store.path();
 }
 
-void FanController::saveToSettings()
+void FanController::migrateFromSettings()
 {
-    for (int profile = 0; profile < 3; profile++) {
-        QString cpuKey = QString("profile%1/cpu").arg(profile);
-        QString gpuKey = QString("profile%1/gpu").arg(profile);
-
-        // Save CPU curve
-        QJsonArray cpuArr;
-        for (const auto &point : m_cpuCurves[profile]) {
-            QVariantMap map = point.toMap();
-            cpuArr.append(QJsonObject{
-                {"temp", map["temp"].toInt()},
-                {"fan", map["fan"].toInt()}
-            });
+    QSettings settings("g-helper-linux", "fan-curves");
+
+    auto readCurve = [&settings](const QString &key) {
+        QVariantList curve;
+        if (!settings.contains(key)) return curve;
+
+        QJsonDocument doc = QJsonDocument::fromJson(settings.value(key).toByteArray());
+        if (doc.isArray()) {
+            for (const auto &item : doc.array()) {
+                QJsonObject obj = item.toObject();
+                curve.append(QVariantMap{
+                    {"temp", obj["temp"].toInt()},
+                    {"fan", obj["fan"].toInt()}
+                });
+            }
         }
-        m_settings.setValue(cpuKey, QJsonDocument(cpuArr).toJson(QJsonDocument::Compact));
-
-        // Save GPU curve
-        QJsonArray gpuArr;
-        for (const auto &point : m_gpuCurves[profile]) {
-            QVariantMap map = point.toMap();
-            gpuArr.append(QJsonObject{
-                {"temp", map["temp"].toInt()},
-                {"fan", map["fan"].toInt()}
-            });
+        return curve;
+    };
+
+    // Older versions only knew about the CPU and GPU fans
+    for (int profile = 0; profile < PROFILE_COUNT; profile++) {
+        QVariantList cpuCurve = readCurve(QString("profile%1/cpu").arg(profile));
+        if (!cpuCurve.isEmpty()) {
+            m_curves[profile][CpuFan] = cpuCurve;
+        }
+        QVariantList gpuCurve = readCurve(QString("profile%1/gpu").arg(profile));
+        if (!gpuCurve.isEmpty()) {
+            m_curves[profile][GpuFan] = gpuCurve;
         }
-        m_settings.setValue(gpuKey, QJsonDocument(gpuArr).toJson(QJsonDocument::Compact));
     }
-    m_settings.sync();
-    qDebug() << "FanController: Saved curves to settings";
+    qDebug() << "FanController: Migrated curves from settings";
 }
 
-void FanController::setCpuCurve(const QVariantList &points, bool enabled)
+void FanController::saveToStore(int profile)
 {
-    qDebug() << "FanController::setCpuCurve for profile" << m_currentProfile << "with" << points.size() << "points";
-
-    m_cpuCurves[m_currentProfile] = points;
-    m_cpuCurveEnabled = enabled;
+    for (int fan = 0; fan < MAX_FANS; fan++) {
+        m_store.setCurve(profile, fan, m_curves[profile][fan], m_curveEnabled[profile][fan]);
+    }
+    m_store.flush();
+}
 
-    // Save to settings
-    saveToSettings();
+void FanController::setFanCount(int count)
+{
+    // hwmon may not expose fans at all; keep the CPU/GPU default then
+    if (count <= 0) return;
+
+    count = qMin(count, static_cast<int>(MAX_FANS));
+    if (m_fanCount != count) {
+        m_fanCount = count;
+        qDebug() << "FanController: Managing" << count << "fans";
+        emit fanCountChanged(count);
+        emit fanCurvesChanged();
+    }
+}
 
-    emit fanCurvesChanged();
+QVariantList FanController::curves() const
+{
+    QVariantList result;
+    for (int fan = 0; fan < m_fanCount; fan++) {
+        result.append(QVariant(m_curves[m_currentProfile][fan]));
+    }
+    return result;
+}
 
-    // Always apply to hardware immediately (current profile is being edited)
-    if (m_available) {
-        qDebug() << "FanController: Applying CPU curve to hardware immediately";
-        m_client->setFanCurve(static_cast<quint32>(m_currentProfile), CpuFan, points, enabled);
+QVariantList FanController::curvesEnabled() const
+{
+    QVariantList result;
+    for (int fan = 0; fan < m_fanCount; fan++) {
+        result.append(m_curveEnabled[m_currentProfile][fan]);
     }
+    return result;
 }
 
-void FanController::setGpuCurve(const QVariantList &points, bool enabled)
+QVariantList FanController::curve(int fan) const
+{
+    if (fan < 0 || fan >= m_fanCount) return QVariantList();
+    return m_curves[m_currentProfile][fan];
+}
+
+bool FanController::curveEnabled(int fan) const
+{
+    if (fan < 0 || fan >= m_fanCount) return false;
+    return m_curveEnabled[m_currentProfile][fan];
+}
+
+void FanController::setCurve(int fan, const QVariantList &points, bool enabled)
 {
-    qDebug() << "FanController::setGpuCurve for profile" << m_currentProfile << "with" << points.size() << "points";
+    if (fan < 0 || fan >= m_fanCount) return;
 
-    m_gpuCurves[m_currentProfile] = points;
-    m_gpuCurveEnabled = enabled;
+    qDebug() << "FanController::setCurve fan" << fan << "for profile" << m_currentProfile
+             << "with" << points.size() << "points";
 
-    // Save to settings
-    saveToSettings();
+    m_curves[m_currentProfile][fan] = points;
+    m_curveEnabled[m_currentProfile][fan] = enabled;
+
+    // Persist (only writes if something changed)
+    saveToStore(m_currentProfile);
 
     emit fanCurvesChanged();
 
     // Always apply to hardware immediately (current profile is being edited)
     if (m_available) {
-        qDebug() << "FanController: Applying GPU curve to hardware immediately";
-        m_client->setFanCurve(static_cast<quint32>(m_currentProfile), GpuFan, points, enabled);
+        m_client->setFanCurves(static_cast<quint32>(m_currentProfile),
+                               {curveData(m_currentProfile, fan)});
     }
 }
 
+void FanController::setCpuCurve(const QVariantList &points, bool enabled)
+{
+    setCurve(CpuFan, points, enabled);
+}
+
+void FanController::setGpuCurve(const QVariantList &points, bool enabled)
+{
+    setCurve(GpuFan, points, enabled);
+}
+
 void FanController::setCurrentProfile(int profile)
 {
-    if (profile < 0 || profile > 2) return;
+    if (profile < 0 || profile >= PROFILE_COUNT) return;
     if (m_currentProfile == profile) return;
 
     qDebug() << "FanController::setCurrentProfile from" << m_currentProfile << "to" << profile;
@@ -174,7 +211,9 @@ void FanController::resetToDefaults()
     qDebug() << "FanController::resetToDefaults - resetting all profiles";
 
     initializeDefaultCurves();
-    saveToSettings();
+    for (int profile = 0; profile < PROFILE_COUNT; profile++) {
+        saveToStore(profile);
+    }
     emit fanCurvesChanged();
 
     if (m_available) {
@@ -186,16 +225,20 @@ void FanController::resetCurrentProfileToDefaults()
 {
     qDebug() << "FanController::resetCurrentProfileToDefaults for profile" << m_currentProfile;
 
-    m_cpuCurves[m_currentProfile] = defaultCurve(m_currentProfile);
-    m_gpuCurves[m_currentProfile] = defaultCurve(m_currentProfile);
-    saveToSettings();
+    for (int fan = 0; fan < MAX_FANS; fan++) {
+        m_curves[m_currentProfile][fan] = defaultCurve(m_currentProfile);
+    }
+    saveToStore(m_currentProfile);
     emit fanCurvesChanged();
 }
 
 void FanController::refresh()
 {
-    loadFromSettings();
-    emit fanCurvesChanged();
+    // Cached in memory; only re-read if the file was changed behind our back
+    if (m_store.reloadIfChanged()) {
+        pullFromStore();
+        emit fanCurvesChanged();
+    }
 }
 
 QVariantList FanController::defaultCurve(int profile)
@@ -253,6 +296,8 @@ void FanController::onFanCurvesChanged()
 void FanController::onProfileChanged(quint32 profile)
 {
     int newProfile = static_cast<int>(profile);
+    if (newProfile >= PROFILE_COUNT) return;
+
     if (m_currentProfile != newProfile) {
         m_currentProfile = newProfile;
         emit currentProfileChanged(newProfile);
@@ -267,15 +312,29 @@ void FanController::applyCurrentCurvesToHardware()
 {
     if (!m_available) return;
 
-    qDebug() << "FanController: Applying curves for profile" << m_currentProfile << "to hardware";
+    qDebug() << "FanController: Applying" << m_fanCount << "curves for profile"
+             << m_currentProfile << "to hardware";
 
-    // Send CPU curve
-    m_client->setFanCurve(static_cast<quint32>(m_currentProfile), CpuFan,
-                          m_cpuCurves[m_currentProfile], m_cpuCurveEnabled);
+    // One batch for all fans of the profile
+    QList<FanCurveData> batch;
+    for (int fan = 0; fan < m_fanCount; fan++) {
+        batch.append(curveData(m_currentProfile, fan));
+    }
+    m_client->setFanCurves(static_cast<quint32>(m_currentProfile), batch);
+}
 
-    // Send GPU curve
-    m_client->setFanCurve(static_cast<quint32>(m_currentProfile), GpuFan,
-                          m_gpuCurves[m_currentProfile], m_gpuCurveEnabled);
+FanCurveData FanController::curveData(int profile, int fan) const
+{
+    FanCurveData data;
+    data.profile = static_cast<quint32>(profile);
+    data.fanType = static_cast<quint32>(fan);
+    data.enabled = m_curveEnabled[profile][fan];
+    for (const QVariant &point : m_curves[profile][fan]) {
+        QVariantMap map = point.toMap();
+        data.points.append({static_cast<quint8>(qBound(0, map["temp"].toInt(), 255)),
+                            static_cast<quint8>(qBound(0, map["fan"].toInt(), 100))});
+    }
+    return data;
 }
 
 void FanController::onClientConnected(bool connected)
@@ -284,7 +343,7 @@ void FanController::onClientConnected(bool connected)
         m_available = connected;
         emit availableChanged(connected);
 
-        if (connected) {
+        if (connected && static_cast<int>(m_client->platformProfile()) < PROFILE_COUNT) {
             m_currentProfile = static_cast<int>(m_client->platformProfile());
             emit currentProfileChanged(m_currentProfile);
         }
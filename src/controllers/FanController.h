@@ -3,7 +3,8 @@
 
 #include <QObject>
 #include <QVariantList>
-#include <QSettings>
+#include "FanCurveStore.h"
+#include "DBusTypes.h"
 
 class AsusdClient;
 
@@ -14,13 +15,17 @@ class FanController : public QObject
     Q_PROPERTY(QVariantList gpuCurve READ gpuCurve NOTIFY fanCurvesChanged)
     Q_PROPERTY(bool cpuCurveEnabled READ cpuCurveEnabled NOTIFY fanCurvesChanged)
     Q_PROPERTY(bool gpuCurveEnabled READ gpuCurveEnabled NOTIFY fanCurvesChanged)
+    Q_PROPERTY(QVariantList curves READ curves NOTIFY fanCurvesChanged)
+    Q_PROPERTY(QVariantList curvesEnabled READ curvesEnabled NOTIFY fanCurvesChanged)
+    Q_PROPERTY(int fanCount READ fanCount NOTIFY fanCountChanged)
     Q_PROPERTY(int currentProfile READ currentProfile WRITE setCurrentProfile NOTIFY currentProfileChanged)
     Q_PROPERTY(bool available READ isAvailable NOTIFY availableChanged)
 
 public:
     enum FanType {
         CpuFan = 0,
-        GpuFan = 1
+        GpuFan = 1,
+        MidFan = 2
     };
     Q_ENUM(FanType)
 
@@ -31,16 +36,28 @@ public:
     };
     Q_ENUM(Profile)
 
+    static constexpr int PROFILE_COUNT = FanCurveStore::PROFILE_COUNT;
+    static constexpr int MAX_FANS = FanCurveStore::MAX_FANS;
+
     explicit FanController(AsusdClient *client, QObject *parent = nullptr);
     ~FanController() override;
 
-    QVariantList cpuCurve() const { return m_cpuCurves[m_currentProfile]; }
-    QVariantList gpuCurve() const { return m_gpuCurves[m_currentProfile]; }
-    bool cpuCurveEnabled() const { return m_cpuCurveEnabled; }
-    bool gpuCurveEnabled() const { return m_gpuCurveEnabled; }
+    QVariantList cpuCurve() const { return m_curves[m_currentProfile][CpuFan]; }
+    QVariantList gpuCurve() const { return m_curves[m_currentProfile][GpuFan]; }
+    bool cpuCurveEnabled() const { return m_curveEnabled[m_currentProfile][CpuFan]; }
+    bool gpuCurveEnabled() const { return m_curveEnabled[m_currentProfile][GpuFan]; }
+    QVariantList curves() const;
+    QVariantList curvesEnabled() const;
+    int fanCount() const { return m_fanCount; }
     int currentProfile() const { return m_currentProfile; }
     bool isAvailable() const { return m_available; }
 
+    // Number of fans found at runtime (from hwmon); clamped to MAX_FANS
+    void setFanCount(int count);
+
+    Q_INVOKABLE QVariantList curve(int fan) const;
+    Q_INVOKABLE bool curveEnabled(int fan) const;
+    Q_INVOKABLE void setCurve(int fan, const QVariantList &points, bool enabled);
     Q_INVOKABLE void setCpuCurve(const QVariantList &points, bool enabled);
     Q_INVOKABLE void setGpuCurve(const QVariantList &points, bool enabled);
     Q_INVOKABLE void setCurrentProfile(int profile);
@@ -52,6 +69,7 @@ public:
 
 signals:
     void fanCurvesChanged();
+    void fanCountChanged(int count);
     void currentProfileChanged(int profile);
     void availableChanged(bool available);
     void errorOccurred(const QString &error);
@@ -63,20 +81,22 @@ private slots:
 
 private:
     void loadFanCurves();
-    void loadFromSettings();
-    void saveToSettings();
+    void loadFromStore();
+    void migrateFromSettings();
+    void pullFromStore();
+    void saveToStore(int profile);
     void initializeDefaultCurves();
     void applyCurrentCurvesToHardware();
+    FanCurveData curveData(int profile, int fan) const;
 
     AsusdClient *m_client;
-    QSettings m_settings;
+    FanCurveStore m_store;
 
-    // 3 profiles, each with CPU and GPU curves
-    QVariantList m_cpuCurves[3];
-    QVariantList m_gpuCurves[3];
+    // Flat per-profile, per-fan tables indexed by FanType
+    QVariantList m_curves[PROFILE_COUNT][MAX_FANS];
+    bool m_curveEnabled[PROFILE_COUNT][MAX_FANS];
 
-    bool m_cpuCurveEnabled = true;
-    bool m_gpuCurveEnabled = true;
+    int m_fanCount = 2;
     int m_currentProfile = 1; // Balanced
     bool m_available = false;
 };
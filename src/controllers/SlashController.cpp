@@ -1,5 +1,7 @@
 #include "SlashController.h"
+#include "Trace.h"
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QRegularExpression>
 
@@ -19,11 +21,35 @@ SlashController::~SlashController() = default;
 
 void SlashController::checkAvailability()
 {
-    QProcess process;
-    process.start("asusctl", QStringList{"slash", "--help"});
-    process.waitForFinished(3000);
-    m_available = (process.exitCode() == 0);
-    emit availableChanged(m_available);
+    // Probed in the background; available flips once asusctl has answered
+    auto *process = new QProcess(this);
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 traceStart = Trace::now();
+
+    connect(process, &QProcess::finished, this, [this, process, timer, traceStart](int exitCode, QProcess::ExitStatus status) {
+        qDebug() << "SlashController: Probe finished in" << timer.elapsed() << "ms";
+        Trace::complete("asusctl slash --help", "probe", traceStart, Trace::now());
+        setAvailable(status == QProcess::NormalExit && exitCode == 0);
+        process->deleteLater();
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError error) {
+        // No asusctl at all: finished() is never emitted in this case
+        if (error == QProcess::FailedToStart) {
+            setAvailable(false);
+            process->deleteLater();
+        }
+    });
+
+    process->start("asusctl", QStringList{"slash", "--help"});
+}
+
+void SlashController::setAvailable(bool available)
+{
+    if (m_available != available) {
+        m_available = available;
+        emit availableChanged(available);
+    }
 
     if (m_available) {
         fetchCurrentState();
@@ -119,13 +145,23 @@ void SlashController::setMode(const QString &mode)
 
 void SlashController::runAsusctl(const QStringList &args)
 {
-    QProcess process;
-    process.start("asusctl", args);
-    process.waitForFinished(3000);
-
-    if (process.exitCode() != 0) {
-        QString error = QString::fromUtf8(process.readAllStandardError());
-        qWarning() << "asusctl command failed:" << args << error;
-        emit errorOccurred(error);
-    }
+    // The value is already shown; report failures whenever asusctl returns
+    auto *process = new QProcess(this);
+    connect(process, &QProcess::finished, this, [this, process, args](int exitCode, QProcess::ExitStatus) {
+        if (exitCode != 0) {
+            QString error = QString::fromUtf8(process->readAllStandardError());
+            qWarning() << "asusctl command failed:" << args << error;
+            emit errorOccurred(error);
+        }
+        process->deleteLater();
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, process, args](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            qWarning() << "asusctl command failed to start:" << args;
+            emit errorOccurred(process->errorString());
+            process->deleteLater();
+        }
+    });
+
+    process->start("asusctl", args);
 }
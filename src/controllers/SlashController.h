@@ -38,6 +38,7 @@ signals:
 private:
     void runAsusctl(const QStringList &args);
     void checkAvailability();
+    void setAvailable(bool available);
     void fetchCurrentState();
 
     bool m_enabled = true;
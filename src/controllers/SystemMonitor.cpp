@@ -1,9 +1,11 @@
 #include "SystemMonitor.h"
+#include "Trace.h"
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
 #include <QDebug>
 #include <QProcess>
+#include <QRegularExpression>
 
 SystemMonitor::SystemMonitor(QObject *parent)
     : QObject(parent)
@@ -12,6 +14,8 @@ SystemMonitor::SystemMonitor(QObject *parent)
     m_updateTimer->setInterval(1000); // Update every second
     connect(m_updateTimer, &QTimer::timeout, this, &SystemMonitor::update);
 
+    m_thermalModel.setHorizon(m_predictionHorizon * 1000 / m_updateTimer->interval());
+
     findHwmonPaths();
 }
 
@@ -36,10 +40,41 @@ void SystemMonitor::stop()
 void SystemMonitor::setUpdateInterval(int msec)
 {
     m_updateTimer->setInterval(qMax(100, msec));
+    // The model is fitted per sample, so a new interval means a new model
+    m_thermalModel.reset();
+
+    // A shorter interval fits fewer seconds into the model's history
+    const int seconds = qMin(m_predictionHorizon, maxPredictionHorizon());
+    m_thermalModel.setHorizon(qMax(1, seconds * 1000 / m_updateTimer->interval()));
+    if (m_predictionHorizon != seconds) {
+        m_predictionHorizon = seconds;
+        emit predictionHorizonChanged(seconds);
+    }
+}
+
+int SystemMonitor::predictionHorizon() const
+{
+    return m_predictionHorizon;
+}
+
+void SystemMonitor::setPredictionHorizon(int seconds)
+{
+    seconds = qBound(1, seconds, maxPredictionHorizon());
+    if (m_predictionHorizon != seconds) {
+        m_predictionHorizon = seconds;
+        m_thermalModel.setHorizon(qMax(1, seconds * 1000 / m_updateTimer->interval()));
+        emit predictionHorizonChanged(seconds);
+    }
+}
+
+int SystemMonitor::maxPredictionHorizon() const
+{
+    return qBound(1, ThermalModel::maxHorizon() * m_updateTimer->interval() / 1000, MAX_PREDICTION_HORIZON);
 }
 
 void SystemMonitor::findHwmonPaths()
 {
+    TRACE_SPAN("SystemMonitor::findHwmonPaths", "hwmon");
     QDir hwmonDir("/sys/class/hwmon");
     QStringList hwmonDevices = hwmonDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
 
@@ -82,31 +117,36 @@ void SystemMonitor::findHwmonPaths()
                 }
             }
 
-            // ASUS WMI for fan speeds
+            // ASUS WMI for fan speeds (fan1 = CPU, fan2 = GPU, fan3 = Mid on some Strix)
             if (name == "asus-nb-wmi" || name == "asus_fan" || name == "asus") {
                 QDir deviceDir(basePath);
 
-                // Look for fan inputs
+                static const QRegularExpression fanRe("^fan(\\d+)_input$");
                 QStringList fanFiles = deviceDir.entryList(QStringList() << "fan*_input", QDir::Files);
                 for (const QString &fanFile : fanFiles) {
-                    QString fanPath = basePath + "/" + fanFile;
-                    if (fanFile.contains("1")) {
-                        m_cpuFanPath = fanPath;
-                        qDebug() << "Found CPU fan at:" << m_cpuFanPath;
-                    } else if (fanFile.contains("2")) {
-                        m_gpuFanPath = fanPath;
-                        qDebug() << "Found GPU fan at:" << m_gpuFanPath;
+                    QRegularExpressionMatch match = fanRe.match(fanFile);
+                    if (!match.hasMatch()) continue;
+
+                    int fan = match.captured(1).toInt() - 1;
+                    if (fan < 0 || fan >= MAX_FANS) continue;
+                    if (m_fanPaths.size() <= fan) {
+                        m_fanPaths.resize(fan + 1);
                     }
+                    m_fanPaths[fan] = basePath + "/" + fanFile;
+                    qDebug() << "Found fan" << fan << "at:" << m_fanPaths[fan];
                 }
 
                 // Alternative naming
-                if (m_cpuFanPath.isEmpty() && deviceDir.exists("pwm1")) {
-                    m_cpuFanPath = basePath + "/pwm1";
+                if (m_fanPaths.isEmpty() && deviceDir.exists("pwm1")) {
+                    m_fanPaths.append(basePath + "/pwm1");
                 }
             }
         }
     }
 
+    m_fanRpms = QList<int>(m_fanPaths.size(), 0);
+    emit fanCountChanged(m_fanPaths.size());
+
     m_available = !m_cpuTempPath.isEmpty() || !m_gpuTempPath.isEmpty();
     emit availableChanged(m_available);
 
@@ -129,8 +169,49 @@ void SystemMonitor::findHwmonPaths()
     }
 }
 
+void SystemMonitor::setNotificationsSuspended(bool suspended)
+{
+    if (m_notificationsSuspended == suspended) return;
+    m_notificationsSuspended = suspended;
+    if (!suspended) {
+        TRACE_SPAN("SystemMonitor flush", "ui");
+        emitAllChanged();
+    }
+}
+
+void SystemMonitor::emitAllChanged()
+{
+    emit cpuTempChanged(m_cpuTemp);
+    emit gpuTempChanged(m_gpuTemp);
+    emit cpuFanRpmChanged(cpuFanRpm());
+    emit gpuFanRpmChanged(gpuFanRpm());
+    emit cpuFanPercentChanged(cpuFanPercent());
+    emit gpuFanPercentChanged(gpuFanPercent());
+    emit fanCountChanged(fanCount());
+    emit fanRpmsChanged();
+    emit cpuUsageChanged(m_cpuUsage);
+    emit gpuUsageChanged(m_gpuUsage);
+    emit dgpuUsageChanged(m_dgpuUsage);
+    emit dgpuTempChanged(m_dgpuTemp);
+    emit memoryChanged();
+    emit apuPowerChanged(m_apuPower);
+    emit systemPowerChanged(m_systemPower);
+    emit displayPowerChanged(m_displayPower);
+    emit batteryPowerChanged(m_batteryPower);
+    emit displayBrightnessChanged(m_displayBrightness);
+    emit onBatteryChanged(m_onBattery);
+    emit predictedCpuTempChanged(m_predictedCpuTemp);
+    emit thermalPredictionErrorChanged(m_thermalPredictionError);
+    emit availableChanged(m_available);
+}
+
 void SystemMonitor::update()
 {
+    // Values still update while suspended; only their NOTIFY signals wait
+    // for setNotificationsSuspended(false)
+    const bool quiet = m_notificationsSuspended && !signalsBlocked();
+    if (quiet) blockSignals(true);
+
     // Read temperatures
     if (!m_cpuTempPath.isEmpty()) {
         int temp = readTemperature(m_cpuTempPath);
@@ -149,25 +230,7 @@ void SystemMonitor::update()
     }
 
     // Read fan speeds
-    if (!m_cpuFanPath.isEmpty()) {
-        int rpm = readFanSpeed(m_cpuFanPath);
-        if (rpm != m_cpuFanRpm) {
-            m_cpuFanRpm = rpm;
-            m_cpuFanPercent = qMin(100, (rpm * 100) / MAX_FAN_RPM);
-            emit cpuFanRpmChanged(rpm);
-            emit cpuFanPercentChanged(m_cpuFanPercent);
-        }
-    }
-
-    if (!m_gpuFanPath.isEmpty()) {
-        int rpm = readFanSpeed(m_gpuFanPath);
-        if (rpm != m_gpuFanRpm) {
-            m_gpuFanRpm = rpm;
-            m_gpuFanPercent = qMin(100, (rpm * 100) / MAX_FAN_RPM);
-            emit gpuFanRpmChanged(rpm);
-            emit gpuFanPercentChanged(m_gpuFanPercent);
-        }
-    }
+    readFanSpeeds();
 
     // Read CPU/GPU usage and power
     readCpuUsage();
@@ -178,6 +241,10 @@ void SystemMonitor::update()
     readDisplayBrightness();
     readBatteryPower();
     calculateSystemPower();
+    updateThermalPrediction();
+
+    if (quiet) blockSignals(false);
+    emit sampled();
 }
 
 int SystemMonitor::readTemperature(const QString &path)
@@ -204,6 +271,38 @@ int SystemMonitor::readFanSpeed(const QString &path)
     return 0;
 }
 
+void SystemMonitor::readFanSpeeds()
+{
+    bool changed = false;
+
+    for (int fan = 0; fan < m_fanPaths.size(); fan++) {
+        if (m_fanPaths[fan].isEmpty()) continue;
+
+        int rpm = readFanSpeed(m_fanPaths[fan]);
+        if (rpm == m_fanRpms[fan]) continue;
+
+        m_fanRpms[fan] = rpm;
+        changed = true;
+
+        if (fan == CpuFan) {
+            emit cpuFanRpmChanged(rpm);
+            emit cpuFanPercentChanged(fanPercent(fan));
+        } else if (fan == GpuFan) {
+            emit gpuFanRpmChanged(rpm);
+            emit gpuFanPercentChanged(fanPercent(fan));
+        }
+    }
+
+    if (changed) {
+        emit fanRpmsChanged();
+    }
+}
+
+int SystemMonitor::fanPercent(int fan) const
+{
+    return qMin(100, (m_fanRpms.value(fan) * 100) / MAX_FAN_RPM);
+}
+
 void SystemMonitor::readCpuUsage()
 {
     QFile file("/proc/stat");
@@ -212,38 +311,46 @@ void SystemMonitor::readCpuUsage()
         QString line = in.readLine();
         file.close();
 
-        if (line.startsWith("cpu ")) {
-            QStringList parts = line.split(' ', Qt::SkipEmptyParts);
-            if (parts.size() >= 5) {
-                qint64 user = parts[1].toLongLong();
-                qint64 nice = parts[2].toLongLong();
-                qint64 system = parts[3].toLongLong();
-                qint64 idle = parts[4].toLongLong();
-                qint64 iowait = parts.size() > 5 ? parts[5].toLongLong() : 0;
-
-                qint64 totalTime = user + nice + system + idle + iowait;
-                qint64 idleTime = idle + iowait;
-
-                if (m_prevTotalTime > 0) {
-                    qint64 totalDiff = totalTime - m_prevTotalTime;
-                    qint64 idleDiff = idleTime - m_prevIdleTime;
-
-                    if (totalDiff > 0) {
-                        double usage = 100.0 * (1.0 - static_cast<double>(idleDiff) / totalDiff);
-                        if (qAbs(m_cpuUsage - usage) > 0.5) {
-                            m_cpuUsage = usage;
-                            emit cpuUsageChanged(usage);
-                        }
+        qint64 totalTime = 0;
+        qint64 idleTime = 0;
+        if (parseCpuTimes(line, &totalTime, &idleTime)) {
+            if (m_prevTotalTime > 0) {
+                qint64 totalDiff = totalTime - m_prevTotalTime;
+                qint64 idleDiff = idleTime - m_prevIdleTime;
+
+                if (totalDiff > 0) {
+                    double usage = 100.0 * (1.0 - static_cast<double>(idleDiff) / totalDiff);
+                    if (qAbs(m_cpuUsage - usage) > 0.5) {
+                        m_cpuUsage = usage;
+                        emit cpuUsageChanged(usage);
                     }
                 }
-
-                m_prevTotalTime = totalTime;
-                m_prevIdleTime = idleTime;
             }
+
+            m_prevTotalTime = totalTime;
+            m_prevIdleTime = idleTime;
         }
     }
 }
 
+bool SystemMonitor::parseCpuTimes(const QString &line, qint64 *totalTime, qint64 *idleTime)
+{
+    if (!line.startsWith("cpu ")) return false;
+
+    QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+    if (parts.size() < 5) return false;
+
+    qint64 user = parts[1].toLongLong();
+    qint64 nice = parts[2].toLongLong();
+    qint64 system = parts[3].toLongLong();
+    qint64 idle = parts[4].toLongLong();
+    qint64 iowait = parts.size() > 5 ? parts[5].toLongLong() : 0;
+
+    *totalTime = user + nice + system + idle + iowait;
+    *idleTime = idle + iowait;
+    return true;
+}
+
 void SystemMonitor::readGpuUsage()
 {
     // Try AMD GPU usage
@@ -298,18 +405,10 @@ void SystemMonitor::readMemoryInfo()
 {
     QFile file("/proc/meminfo");
     if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream in(&file);
         qint64 memTotal = 0, memAvailable = 0;
-
-        while (!in.atEnd()) {
-            QString line = in.readLine();
-            if (line.startsWith("MemTotal:")) {
-                memTotal = line.split(' ', Qt::SkipEmptyParts)[1].toLongLong();
-            } else if (line.startsWith("MemAvailable:")) {
-                memAvailable = line.split(' ', Qt::SkipEmptyParts)[1].toLongLong();
-            }
-        }
+        const bool ok = parseMemInfo(file.readAll(), &memTotal, &memAvailable);
         file.close();
+        if (!ok) return;
 
         int total = static_cast<int>(memTotal / 1024); // MB
         int used = static_cast<int>((memTotal - memAvailable) / 1024); // MB
@@ -322,6 +421,24 @@ void SystemMonitor::readMemoryInfo()
     }
 }
 
+bool SystemMonitor::parseMemInfo(const QByteArray &data, qint64 *memTotal, qint64 *memAvailable)
+{
+    bool haveTotal = false;
+    bool haveAvailable = false;
+
+    for (const QByteArray &line : data.split('\n')) {
+        if (line.startsWith("MemTotal:")) {
+            *memTotal = line.simplified().split(' ').value(1).toLongLong();
+            haveTotal = true;
+        } else if (line.startsWith("MemAvailable:")) {
+            *memAvailable = line.simplified().split(' ').value(1).toLongLong();
+            haveAvailable = true;
+        }
+        if (haveTotal && haveAvailable) return true;
+    }
+    return haveTotal;
+}
+
 void SystemMonitor::readApuPower()
 {
     if (m_apuPowerPath.isEmpty()) return;
@@ -444,3 +561,22 @@ void SystemMonitor::calculateSystemPower()
         emit systemPowerChanged(systemPower);
     }
 }
+
+void SystemMonitor::updateThermalPrediction()
+{
+    if (m_cpuTempPath.isEmpty() || m_apuPowerPath.isEmpty()) return;
+
+    m_thermalModel.addSample(m_cpuTemp, m_apuPower);
+
+    int predicted = qRound(m_thermalModel.predictedTemperature());
+    if (m_predictedCpuTemp != predicted) {
+        m_predictedCpuTemp = predicted;
+        emit predictedCpuTempChanged(predicted);
+    }
+
+    double error = m_thermalModel.predictionError();
+    if (qAbs(m_thermalPredictionError - error) > 0.05) {
+        m_thermalPredictionError = error;
+        emit thermalPredictionErrorChanged(error);
+    }
+}
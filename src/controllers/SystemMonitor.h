@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QTimer>
 #include <QMap>
+#include "ThermalModel.h"
 
 class SystemMonitor : public QObject
 {
@@ -14,6 +15,8 @@ class SystemMonitor : public QObject
     Q_PROPERTY(int gpuFanRpm READ gpuFanRpm NOTIFY gpuFanRpmChanged)
     Q_PROPERTY(int cpuFanPercent READ cpuFanPercent NOTIFY cpuFanPercentChanged)
     Q_PROPERTY(int gpuFanPercent READ gpuFanPercent NOTIFY gpuFanPercentChanged)
+    Q_PROPERTY(int fanCount READ fanCount NOTIFY fanCountChanged)
+    Q_PROPERTY(QList<int> fanRpms READ fanRpms NOTIFY fanRpmsChanged)
     Q_PROPERTY(double cpuUsage READ cpuUsage NOTIFY cpuUsageChanged)
     Q_PROPERTY(double gpuUsage READ gpuUsage NOTIFY gpuUsageChanged)
     Q_PROPERTY(double dgpuUsage READ dgpuUsage NOTIFY dgpuUsageChanged)
@@ -26,18 +29,33 @@ class SystemMonitor : public QObject
     Q_PROPERTY(double batteryPower READ batteryPower NOTIFY batteryPowerChanged)
     Q_PROPERTY(int displayBrightness READ displayBrightness NOTIFY displayBrightnessChanged)
     Q_PROPERTY(bool onBattery READ isOnBattery NOTIFY onBatteryChanged)
+    Q_PROPERTY(int predictedCpuTemp READ predictedCpuTemp NOTIFY predictedCpuTempChanged)
+    Q_PROPERTY(double thermalPredictionError READ thermalPredictionError NOTIFY thermalPredictionErrorChanged)
+    Q_PROPERTY(int predictionHorizon READ predictionHorizon WRITE setPredictionHorizon NOTIFY predictionHorizonChanged)
     Q_PROPERTY(bool available READ isAvailable NOTIFY availableChanged)
 
 public:
+    // Indices into the fan arrays, matching asus-nb-wmi's fan1..fan3
+    enum Fan {
+        CpuFan = 0,
+        GpuFan = 1,
+        MidFan = 2
+    };
+    Q_ENUM(Fan)
+
     explicit SystemMonitor(QObject *parent = nullptr);
     ~SystemMonitor() override;
 
     int cpuTemp() const { return m_cpuTemp; }
     int gpuTemp() const { return m_gpuTemp; }
-    int cpuFanRpm() const { return m_cpuFanRpm; }
-    int gpuFanRpm() const { return m_gpuFanRpm; }
-    int cpuFanPercent() const { return m_cpuFanPercent; }
-    int gpuFanPercent() const { return m_gpuFanPercent; }
+    int cpuFanRpm() const { return m_fanRpms.value(CpuFan); }
+    int gpuFanRpm() const { return m_fanRpms.value(GpuFan); }
+    int cpuFanPercent() const { return fanPercent(CpuFan); }
+    int gpuFanPercent() const { return fanPercent(GpuFan); }
+    int fanCount() const { return m_fanPaths.size(); }
+    QList<int> fanRpms() const { return m_fanRpms; }
+    Q_INVOKABLE int fanRpm(int fan) const { return m_fanRpms.value(fan); }
+    Q_INVOKABLE int fanPercent(int fan) const;
     double cpuUsage() const { return m_cpuUsage; }
     double gpuUsage() const { return m_gpuUsage; }
     double dgpuUsage() const { return m_dgpuUsage; }
@@ -50,12 +68,29 @@ public:
     double batteryPower() const { return m_batteryPower; }
     int displayBrightness() const { return m_displayBrightness; }
     bool isOnBattery() const { return m_onBattery; }
+    int predictedCpuTemp() const { return m_predictedCpuTemp; }
+    double thermalPredictionError() const { return m_thermalPredictionError; }
+    int predictionHorizon() const;
+    void setPredictionHorizon(int seconds);
     bool isAvailable() const { return m_available; }
 
     Q_INVOKABLE void start();
     Q_INVOKABLE void stop();
     Q_INVOKABLE void setUpdateInterval(int msec);
 
+    // While suspended, sampling continues (sampled() still fires for the
+    // tray and the governor) but the per-property NOTIFY signals are held
+    // back, so a hidden window's bindings don't re-evaluate every second.
+    // Resuming emits every NOTIFY signal once with the latest values.
+    void setNotificationsSuspended(bool suspended);
+    bool notificationsSuspended() const { return m_notificationsSuspended; }
+
+    // procfs parsers behind readCpuUsage()/readMemoryInfo(), public for the
+    // tests and benchmarks. parseCpuTimes takes the "cpu " line of
+    // /proc/stat; parseMemInfo the whole of /proc/meminfo (values in kB).
+    static bool parseCpuTimes(const QString &line, qint64 *totalTime, qint64 *idleTime);
+    static bool parseMemInfo(const QByteArray &data, qint64 *memTotal, qint64 *memAvailable);
+
 signals:
     void cpuTempChanged(int temp);
     void gpuTempChanged(int temp);
@@ -63,6 +98,8 @@ signals:
     void gpuFanRpmChanged(int rpm);
     void cpuFanPercentChanged(int percent);
     void gpuFanPercentChanged(int percent);
+    void fanCountChanged(int count);
+    void fanRpmsChanged();
     void cpuUsageChanged(double usage);
     void gpuUsageChanged(double usage);
     void dgpuUsageChanged(double usage);
@@ -74,7 +111,12 @@ signals:
     void batteryPowerChanged(double power);
     void displayBrightnessChanged(int brightness);
     void onBatteryChanged(bool onBattery);
+    void predictedCpuTempChanged(int temp);
+    void thermalPredictionErrorChanged(double error);
+    void predictionHorizonChanged(int seconds);
     void availableChanged(bool available);
+    // Emitted once per sampling tick after all values have been updated
+    void sampled();
 
 private slots:
     void update();
@@ -83,6 +125,7 @@ private:
     void findHwmonPaths();
     int readTemperature(const QString &path);
     int readFanSpeed(const QString &path);
+    void readFanSpeeds();
     void readCpuUsage();
     void readGpuUsage();
     void readDgpuInfo();
@@ -91,15 +134,19 @@ private:
     void readDisplayBrightness();
     void readBatteryPower();
     void calculateSystemPower();
+    void updateThermalPrediction();
+    // Longest horizon in seconds the thermal model can score at the current interval
+    int maxPredictionHorizon() const;
+    void emitAllChanged();
 
     QTimer *m_updateTimer;
     bool m_available = false;
+    bool m_notificationsSuspended = false;
 
     // Hwmon paths
     QString m_cpuTempPath;
     QString m_gpuTempPath;
-    QString m_cpuFanPath;
-    QString m_gpuFanPath;
+    QList<QString> m_fanPaths; // Indexed by fan id
     QString m_apuPowerPath;
     QString m_backlightPath;
     int m_maxBrightness = 0;
@@ -107,10 +154,7 @@ private:
     // Cached values
     int m_cpuTemp = 0;
     int m_gpuTemp = 0;
-    int m_cpuFanRpm = 0;
-    int m_gpuFanRpm = 0;
-    int m_cpuFanPercent = 0;
-    int m_gpuFanPercent = 0;
+    QList<int> m_fanRpms; // Indexed by fan id, sampled together
     double m_cpuUsage = 0.0;
     double m_gpuUsage = 0.0;
     double m_dgpuUsage = 0.0;
@@ -123,11 +167,19 @@ private:
     double m_batteryPower = 0.0;
     int m_displayBrightness = 0;
     bool m_onBattery = false;
+    int m_predictedCpuTemp = 0;
+    double m_thermalPredictionError = 0.0;
+
+    // Fitted from the cpuTemp/apuPower stream on every sample
+    ThermalModel m_thermalModel;
+    int m_predictionHorizon = 5; // seconds
+    static constexpr int MAX_PREDICTION_HORIZON = 30; // seconds
 
     // For CPU usage calculation
     qint64 m_prevIdleTime = 0;
     qint64 m_prevTotalTime = 0;
 
+    static constexpr int MAX_FANS = 8;
     static constexpr int MAX_FAN_RPM = 6000; // Approximate max RPM for percentage calculation
     static constexpr double MAX_DISPLAY_POWER = 15.0; // Max display power in watts at 100% brightness
     static constexpr double MIN_DISPLAY_POWER = 2.0;  // Min display power in watts at 0% brightness
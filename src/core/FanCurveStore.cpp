@@ -0,0 +1,238 @@
+#include "FanCurveStore.h"
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+
+namespace {
+// magic (4) + version (2) + record count (2)
+constexpr int HEADER_SIZE = 8;
+// profile, fan, enabled, point count
+constexpr int RECORD_HEADER_SIZE = 4;
+}
+
+FanCurveStore::FanCurveStore(const QString &path)
+    : m_path(path)
+{
+}
+
+QString FanCurveStore::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::ConfigLocation)
+        + "/g-helper-linux/fan-curves.bin";
+}
+
+bool FanCurveStore::exists() const
+{
+    return QFileInfo::exists(m_path);
+}
+
+bool FanCurveStore::validIndex(int profile, int fan)
+{
+    return profile >= 0 && profile < PROFILE_COUNT && fan >= 0 && fan < MAX_FANS;
+}
+
+bool FanCurveStore::load()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(m_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QByteArray data = file.readAll();
+    file.close();
+    m_lastModified = QFileInfo(m_path).lastModified();
+
+    const bool ok = decode(data);
+    m_lastLoadNsecs = timer.nsecsElapsed();
+
+    if (ok) {
+        qDebug() << "FanCurveStore: Loaded" << data.size() << "bytes in"
+                 << m_lastLoadNsecs / 1000 << "us";
+    } else {
+        qWarning() << "FanCurveStore: Ignoring invalid store" << m_path;
+    }
+    return ok;
+}
+
+bool FanCurveStore::reloadIfChanged()
+{
+    QFileInfo info(m_path);
+    if (!info.exists() || info.lastModified() == m_lastModified) {
+        return false;
+    }
+    return load();
+}
+
+bool FanCurveStore::decode(const QByteArray &data)
+{
+    if (data.size() < HEADER_SIZE) return false;
+
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+    if (qFromBigEndian<quint32>(bytes) != MAGIC) return false;
+    if (qFromBigEndian<quint16>(bytes + 4) != FORMAT_VERSION) return false;
+    const int count = qFromBigEndian<quint16>(bytes + 6);
+
+    Record records[PROFILE_COUNT][MAX_FANS];
+    int offset = HEADER_SIZE;
+
+    for (int i = 0; i < count; i++) {
+        if (offset + RECORD_HEADER_SIZE > data.size()) return false;
+
+        const int profile = bytes[offset];
+        const int fan = bytes[offset + 1];
+        const bool enabled = bytes[offset + 2] != 0;
+        const int pointCount = bytes[offset + 3];
+        const int size = RECORD_HEADER_SIZE + pointCount * 2;
+        if (offset + size > data.size()) return false;
+
+        // Records for fans this build does not know about are skipped
+        if (validIndex(profile, fan)) {
+            Record &record = records[profile][fan];
+            record.present = true;
+            record.enabled = enabled;
+            record.points.resize(pointCount);
+            for (int p = 0; p < pointCount; p++) {
+                record.points[p] = {bytes[offset + RECORD_HEADER_SIZE + p * 2],
+                                    bytes[offset + RECORD_HEADER_SIZE + p * 2 + 1]};
+            }
+            record.encoded = data.mid(offset, size);
+        }
+        offset += size;
+    }
+
+    for (int profile = 0; profile < PROFILE_COUNT; profile++) {
+        for (int fan = 0; fan < MAX_FANS; fan++) {
+            m_records[profile][fan] = records[profile][fan];
+        }
+    }
+    return true;
+}
+
+bool FanCurveStore::contains(int profile, int fan) const
+{
+    return validIndex(profile, fan) && m_records[profile][fan].present;
+}
+
+QVariantList FanCurveStore::curve(int profile, int fan) const
+{
+    QVariantList result;
+    if (!contains(profile, fan)) return result;
+
+    for (const Point &point : m_records[profile][fan].points) {
+        result.append(QVariantMap{{"temp", int(point.temp)}, {"fan", int(point.fan)}});
+    }
+    return result;
+}
+
+bool FanCurveStore::isEnabled(int profile, int fan) const
+{
+    return contains(profile, fan) ? m_records[profile][fan].enabled : true;
+}
+
+void FanCurveStore::setCurve(int profile, int fan, const QVariantList &points, bool enabled)
+{
+    if (!validIndex(profile, fan)) return;
+
+    QVector<Point> encoded;
+    encoded.reserve(points.size());
+    for (const QVariant &point : points) {
+        const QVariantMap map = point.toMap();
+        encoded.append({static_cast<quint8>(qBound(0, map["temp"].toInt(), 255)),
+                        static_cast<quint8>(qBound(0, map["fan"].toInt(), 100))});
+    }
+
+    Record &record = m_records[profile][fan];
+    bool samePoints = record.points.size() == encoded.size();
+    for (int i = 0; samePoints && i < encoded.size(); i++) {
+        samePoints = record.points[i].temp == encoded[i].temp
+                     && record.points[i].fan == encoded[i].fan;
+    }
+    if (record.present && record.enabled == enabled && samePoints) {
+        return;
+    }
+
+    record.present = true;
+    record.enabled = enabled;
+    record.points = encoded;
+    record.dirty = true;
+}
+
+bool FanCurveStore::isDirty() const
+{
+    for (int profile = 0; profile < PROFILE_COUNT; profile++) {
+        for (int fan = 0; fan < MAX_FANS; fan++) {
+            if (m_records[profile][fan].dirty) return true;
+        }
+    }
+    return false;
+}
+
+QByteArray FanCurveStore::encodeRecord(int profile, int fan, const Record &record)
+{
+    const int pointCount = qMin(static_cast<int>(record.points.size()), 255);
+
+    QByteArray data;
+    data.reserve(RECORD_HEADER_SIZE + pointCount * 2);
+    data.append(static_cast<char>(profile));
+    data.append(static_cast<char>(fan));
+    data.append(static_cast<char>(record.enabled ? 1 : 0));
+    data.append(static_cast<char>(pointCount));
+    for (int i = 0; i < pointCount; i++) {
+        data.append(static_cast<char>(record.points[i].temp));
+        data.append(static_cast<char>(record.points[i].fan));
+    }
+    return data;
+}
+
+bool FanCurveStore::flush()
+{
+    if (!isDirty()) return true;
+
+    QByteArray data(HEADER_SIZE, Qt::Uninitialized);
+    uchar *header = reinterpret_cast<uchar *>(data.data());
+    qToBigEndian<quint32>(MAGIC, header);
+    qToBigEndian<quint16>(FORMAT_VERSION, header + 4);
+
+    quint16 count = 0;
+    for (int profile = 0; profile < PROFILE_COUNT; profile++) {
+        for (int fan = 0; fan < MAX_FANS; fan++) {
+            Record &record = m_records[profile][fan];
+            if (!record.present) continue;
+            // Only dirty records are re-encoded; clean ones reuse their bytes
+            if (record.dirty || record.encoded.isEmpty()) {
+                record.encoded = encodeRecord(profile, fan, record);
+            }
+            data.append(record.encoded);
+            count++;
+        }
+    }
+    qToBigEndian<quint16>(count, reinterpret_cast<uchar *>(data.data()) + 6);
+
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+
+    QSaveFile file(m_path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "FanCurveStore: Failed to write" << m_path << file.errorString();
+        return false;
+    }
+
+    for (int profile = 0; profile < PROFILE_COUNT; profile++) {
+        for (int fan = 0; fan < MAX_FANS; fan++) {
+            m_records[profile][fan].dirty = false;
+        }
+    }
+
+    m_lastModified = QFileInfo(m_path).lastModified();
+    m_lastWriteBytes = data.size();
+    m_totalBytesWritten += data.size();
+    qDebug() << "FanCurveStore: Wrote" << m_lastWriteBytes << "bytes";
+    return true;
+}
@@ -0,0 +1,81 @@
+#ifndef FANCURVESTORE_H
+#define FANCURVESTORE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QVariantList>
+#include <QVector>
+
+// Compact on-disk store for per-profile, per-fan curves.
+//
+// Curves live in a small versioned binary file next to the other config
+// files. The whole store is cached in memory; writes go through QSaveFile
+// (temp file + rename) and only happen when a record actually changed.
+// Clean records are written from their cached encoding, so an edit only
+// re-encodes the record that was touched.
+class FanCurveStore
+{
+public:
+    static constexpr int PROFILE_COUNT = 3;
+    static constexpr int MAX_FANS = 3; // CPU, GPU, Mid
+
+    explicit FanCurveStore(const QString &path = defaultPath());
+
+    static QString defaultPath();
+
+    QString path() const { return m_path; }
+    bool exists() const;
+
+    // Loads the file unconditionally. Returns false if it is missing or invalid.
+    bool load();
+    // Reloads only if the file's modification time differs from the last load/save.
+    bool reloadIfChanged();
+
+    bool contains(int profile, int fan) const;
+    QVariantList curve(int profile, int fan) const;
+    bool isEnabled(int profile, int fan) const;
+
+    // Updates the cached record and marks it dirty if anything changed.
+    void setCurve(int profile, int fan, const QVariantList &points, bool enabled);
+
+    bool isDirty() const;
+    // Writes the store atomically if any record is dirty.
+    bool flush();
+
+    // Instrumentation
+    qint64 lastLoadNsecs() const { return m_lastLoadNsecs; }
+    qint64 lastWriteBytes() const { return m_lastWriteBytes; }
+    qint64 totalBytesWritten() const { return m_totalBytesWritten; }
+
+private:
+    struct Point {
+        quint8 temp;
+        quint8 fan;
+    };
+
+    struct Record {
+        bool present = false;
+        bool enabled = true;
+        bool dirty = false;
+        QVector<Point> points;
+        QByteArray encoded;
+    };
+
+    static bool validIndex(int profile, int fan);
+    static QByteArray encodeRecord(int profile, int fan, const Record &record);
+    bool decode(const QByteArray &data);
+
+    QString m_path;
+    QDateTime m_lastModified;
+    Record m_records[PROFILE_COUNT][MAX_FANS];
+
+    qint64 m_lastLoadNsecs = 0;
+    qint64 m_lastWriteBytes = 0;
+    qint64 m_totalBytesWritten = 0;
+
+    static constexpr quint32 MAGIC = 0x47484643; // "GHFC"
+    static constexpr quint16 FORMAT_VERSION = 1;
+};
+
+#endif // FANCURVESTORE_H
@@ -0,0 +1,144 @@
+#include "LatencyStats.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaEnum>
+#include <QtAlgorithms>
+#include <cstring>
+
+LatencyStats::LatencyStats(QObject *parent)
+    : QObject(parent)
+{
+    reset();
+}
+
+LatencyStats *LatencyStats::instance()
+{
+    static LatencyStats stats;
+    return &stats;
+}
+
+int LatencyStats::bucketIndex(quint64 usecs)
+{
+    if (usecs < SUB_BUCKETS) {
+        return static_cast<int>(usecs);
+    }
+    // Exponent picks the power of two, the next bits pick the sub-bucket
+    const int exponent = 63 - qCountLeadingZeroBits(usecs);
+    const int sub = static_cast<int>((usecs >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+qint64 LatencyStats::bucketUpperBound(int index)
+{
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    const int exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    const int sub = index % SUB_BUCKETS;
+    const int shift = exponent - SUB_BUCKET_BITS;
+    const quint64 lower = static_cast<quint64>(SUB_BUCKETS + sub) << shift;
+    return static_cast<qint64>(lower + (quint64(1) << shift) - 1);
+}
+
+void LatencyStats::record(Operation op, qint64 nsecs, bool error)
+{
+    Histogram &h = m_ops[op];
+    const quint64 usecs = nsecs > 0 ? static_cast<quint64>(nsecs) / 1000 : 0;
+
+    h.buckets[bucketIndex(usecs)]++;
+    h.count++;
+    if (error) h.errors++;
+    if (static_cast<qint64>(usecs) > h.maxUsecs) h.maxUsecs = static_cast<qint64>(usecs);
+}
+
+qint64 LatencyStats::percentile(Operation op, double pct) const
+{
+    const Histogram &h = m_ops[op];
+    if (h.count == 0) return 0;
+
+    const qint64 target = qMax<qint64>(1, static_cast<qint64>(h.count * pct / 100.0 + 0.5));
+    qint64 seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += h.buckets[i];
+        if (seen >= target) {
+            return qMin(bucketUpperBound(i), h.maxUsecs);
+        }
+    }
+    return h.maxUsecs;
+}
+
+QString LatencyStats::operationName(Operation op)
+{
+    return QString::fromLatin1(QMetaEnum::fromType<Operation>().valueToKey(op));
+}
+
+QVariantList LatencyStats::snapshot() const
+{
+    QVariantList result;
+    for (int i = 0; i < OperationCount; i++) {
+        const Operation op = static_cast<Operation>(i);
+        if (m_ops[i].count == 0) continue;
+
+        result.append(QVariantMap{
+            {"name", operationName(op)},
+            {"count", m_ops[i].count},
+            {"errors", m_ops[i].errors},
+            {"p50", percentile(op, 50)},
+            {"p90", percentile(op, 90)},
+            {"p99", percentile(op, 99)},
+            {"max", m_ops[i].maxUsecs}
+        });
+    }
+    return result;
+}
+
+QString LatencyStats::dump() const
+{
+    QString out = QString("%1 %2 %3 %4 %5 %6 %7\n")
+        .arg(QString("operation"), -20).arg(QString("count"), 8).arg(QString("errors"), 7)
+        .arg(QString("p50 us"), 9).arg(QString("p90 us"), 9).arg(QString("p99 us"), 9).arg(QString("max us"), 9);
+
+    const QVariantList rows = snapshot();
+    for (const QVariant &row : rows) {
+        const QVariantMap map = row.toMap();
+        out += QString("%1 %2 %3 %4 %5 %6 %7\n")
+            .arg(map["name"].toString(), -20)
+            .arg(map["count"].toLongLong(), 8)
+            .arg(map["errors"].toLongLong(), 7)
+            .arg(map["p50"].toLongLong(), 9)
+            .arg(map["p90"].toLongLong(), 9)
+            .arg(map["p99"].toLongLong(), 9)
+            .arg(map["max"].toLongLong(), 9);
+    }
+    if (rows.isEmpty()) {
+        out += "(no D-Bus calls recorded)\n";
+    }
+    return out;
+}
+
+QByteArray LatencyStats::toJson() const
+{
+    QJsonObject root;
+    root["application"] = QCoreApplication::applicationName();
+    root["version"] = QCoreApplication::applicationVersion();
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["unit"] = "us";
+    root["operations"] = QJsonArray::fromVariantList(snapshot());
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+bool LatencyStats::writeJson(const QString &path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    return file.write(toJson()) >= 0;
+}
+
+void LatencyStats::reset()
+{
+    std::memset(m_ops, 0, sizeof(m_ops));
+}
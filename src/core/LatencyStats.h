@@ -0,0 +1,84 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <QObject>
+#include <QString>
+#include <QVariantList>
+
+// Per-operation latency histograms and error counts for outgoing D-Bus calls.
+//
+// Each operation owns a fixed log-linear histogram (8 sub-buckets per power
+// of two, so any reading is within 12.5% of the true value) over
+// microseconds. Everything is preallocated; record() is a handful of integer
+// instructions with no allocation and no locking (GUI thread only).
+class LatencyStats : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Operation {
+        PropertiesGetAll = 0,
+        SetPlatformProfile,
+        SetChargeLimit,
+        SetLedBrightness,
+        SetLedMode,
+        SetFanCurve,
+        EnableFanCurves,
+        ReadFanCurves,
+        ResetFanCurves,
+        IntrospectAura,
+        NameHasOwner,
+        GfxMode,
+        GfxSupported,
+        GfxPower,
+        GfxSetMode,
+        OperationCount
+    };
+    Q_ENUM(Operation)
+
+    static LatencyStats *instance();
+
+    void record(Operation op, qint64 nsecs, bool error = false);
+
+    qint64 count(Operation op) const { return m_ops[op].count; }
+    qint64 errors(Operation op) const { return m_ops[op].errors; }
+    // Upper bound of the bucket holding the given percentile, in microseconds
+    qint64 percentile(Operation op, double pct) const;
+    qint64 max(Operation op) const { return m_ops[op].maxUsecs; }
+
+    static QString operationName(Operation op);
+
+    // One map per operation that has samples: name, count, errors, p50, p90, p99, max (us)
+    Q_INVOKABLE QVariantList snapshot() const;
+    // Plain-text table of snapshot(), for --dump-stats
+    QString dump() const;
+    // snapshot() as a JSON document with a timestamp, for --stats-json; one
+    // file per run so results can be collected and compared over time
+    QByteArray toJson() const;
+    bool writeJson(const QString &path) const;
+    Q_INVOKABLE void reset();
+
+    // Histogram layout, public for the tests: bucketIndex() maps
+    // microseconds to a bucket, bucketUpperBound() gives the largest value
+    // that bucket holds.
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static int bucketIndex(quint64 usecs);
+    static qint64 bucketUpperBound(int index);
+
+private:
+    explicit LatencyStats(QObject *parent = nullptr);
+
+    struct Histogram {
+        quint32 buckets[BUCKETS];
+        qint64 count;
+        qint64 errors;
+        qint64 maxUsecs;
+    };
+
+    Histogram m_ops[OperationCount];
+};
+
+#endif // LATENCYSTATS_H
@@ -0,0 +1,60 @@
+#ifndef LAZYSINGLETON_H
+#define LAZYSINGLETON_H
+
+#include <QQmlEngine>
+#include "Trace.h"
+#include <functional>
+#include <memory>
+
+// A QML singleton that is only constructed the first time it is used,
+// from QML or from C++ through get(). C++ keeps ownership, so the instance
+// outlives any QML engine that looked at it.
+template <typename T>
+class LazySingleton
+{
+public:
+    explicit LazySingleton(std::function<T *()> factory)
+        : m_factory(std::move(factory))
+    {
+    }
+
+    T *get()
+    {
+        if (!m_instance) {
+            Trace::Span span(m_name, "qml-singleton");
+            m_instance.reset(m_factory());
+            QQmlEngine::setObjectOwnership(m_instance.get(), QQmlEngine::CppOwnership);
+        }
+        return m_instance.get();
+    }
+
+    // The instance if something already asked for it, else nullptr
+    T *peek() const { return m_instance.get(); }
+
+    // name must be a string literal; it also labels the construction in traces
+    void registerQml(const char *uri, int versionMajor, int versionMinor, const char *name)
+    {
+        m_name = name;
+        qmlRegisterSingletonType<T>(uri, versionMajor, versionMinor, name,
+                                    [this](QQmlEngine *, QJSEngine *) -> QObject * { return get(); });
+    }
+
+private:
+    std::function<T *()> m_factory;
+    std::unique_ptr<T> m_instance;
+    const char *m_name = "LazySingleton";
+};
+
+// A QML singleton for an object that already exists and that C++ owns.
+// Unlike qmlRegisterSingletonInstance(), which binds the object to the
+// first engine that uses it, this serves it to every engine, so the UI
+// can be unloaded and loaded again.
+template <typename T>
+void registerQmlInstance(const char *uri, int versionMajor, int versionMinor, const char *name, T *instance)
+{
+    QQmlEngine::setObjectOwnership(instance, QQmlEngine::CppOwnership);
+    qmlRegisterSingletonType<T>(uri, versionMajor, versionMinor, name,
+                                [instance](QQmlEngine *, QJSEngine *) -> QObject * { return instance; });
+}
+
+#endif // LAZYSINGLETON_H
@@ -0,0 +1,170 @@
+#include "RemoteControl.h"
+#include "AsusdClient.h"
+#include "PerformanceController.h"
+#include "GpuController.h"
+#include "SystemMonitor.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <functional>
+#include <memory>
+
+namespace {
+
+// Runs action now, or the first time target reports itself available
+template<typename Target>
+void whenAvailable(Target *target, bool available, void (Target::*signal)(bool),
+                   QObject *context, std::function<void()> action)
+{
+    if (available) {
+        action();
+        return;
+    }
+    auto pending = std::make_shared<QMetaObject::Connection>();
+    *pending = QObject::connect(target, signal, context, [pending, action](bool ready) {
+        if (!ready) return;
+        QObject::disconnect(*pending);
+        action();
+    });
+}
+
+} // namespace
+
+RemoteControl::RemoteControl(AsusdClient *asusdClient,
+                             PerformanceController *performanceController,
+                             GpuController *gpuController,
+                             SystemMonitor *systemMonitor,
+                             QObject *parent)
+    : QObject(parent)
+    , m_asusdClient(asusdClient)
+    , m_performanceController(performanceController)
+    , m_gpuController(gpuController)
+    , m_systemMonitor(systemMonitor)
+{
+}
+
+RemoteControl::~RemoteControl() = default;
+
+void RemoteControl::addOptions(QCommandLineParser &parser)
+{
+    parser.addOption(QCommandLineOption("minimized",
+        "Start in the tray without opening the window."));
+    parser.addOption(QCommandLineOption("profile",
+        "Switch to a performance profile: silent, balanced or turbo.", "profile"));
+    parser.addOption(QCommandLineOption("gpu-mode",
+        "Switch the GPU mode: eco, standard, ultimate or optimized.", "mode"));
+    parser.addOption(QCommandLineOption("charge-limit",
+        "Set the battery charge limit (20-100).", "percent"));
+    parser.addOption(QCommandLineOption("status",
+        "Print the current profile, GPU mode, charge limit and sensors."));
+}
+
+int RemoteControl::profileFromName(const QString &name)
+{
+    const QString value = name.trimmed().toLower();
+    if (value == "silent" || value == "quiet" || value == "0") return PerformanceController::Quiet;
+    if (value == "balanced" || value == "1") return PerformanceController::Balanced;
+    if (value == "turbo" || value == "performance" || value == "2") return PerformanceController::Performance;
+    return -1;
+}
+
+int RemoteControl::gpuModeFromName(const QString &name)
+{
+    const QString value = name.trimmed().toLower();
+    if (value == "eco" || value == "integrated" || value == "0") return GpuController::Eco;
+    if (value == "standard" || value == "hybrid" || value == "1") return GpuController::Standard;
+    if (value == "ultimate" || value == "dedicated" || value == "2") return GpuController::Ultimate;
+    if (value == "optimized" || value == "vfio" || value == "3") return GpuController::Optimized;
+    return -1;
+}
+
+QString RemoteControl::execute(const QStringList &arguments, bool *acted)
+{
+    QCommandLineParser parser;
+    addOptions(parser);
+    if (!parser.parse(QStringList{QCoreApplication::applicationFilePath()} + arguments)) {
+        if (acted) *acted = true;
+        return parser.errorText() + '\n';
+    }
+    return execute(parser, acted);
+}
+
+QString RemoteControl::execute(const QCommandLineParser &parser, bool *acted)
+{
+    QString reply;
+    bool any = false;
+
+    if (parser.isSet("profile")) {
+        any = true;
+        const int profile = profileFromName(parser.value("profile"));
+        if (profile < 0) {
+            reply += QString("Unknown profile: %1\n").arg(parser.value("profile"));
+        } else {
+            whenAvailable(m_performanceController, m_performanceController->isAvailable(),
+                          &PerformanceController::availableChanged, this, [this, profile]() {
+                m_performanceController->setProfile(profile);
+            });
+        }
+    }
+
+    if (parser.isSet("gpu-mode")) {
+        any = true;
+        const int mode = gpuModeFromName(parser.value("gpu-mode"));
+        if (mode < 0) {
+            reply += QString("Unknown GPU mode: %1\n").arg(parser.value("gpu-mode"));
+        } else {
+            whenAvailable(m_gpuController, m_gpuController->isAvailable(),
+                          &GpuController::availableChanged, this, [this, mode]() {
+                m_gpuController->setMode(mode);
+            });
+        }
+    }
+
+    if (parser.isSet("charge-limit")) {
+        any = true;
+        bool ok = false;
+        const int limit = parser.value("charge-limit").toInt(&ok);
+        if (!ok || limit < 20 || limit > 100) {
+            reply += QString("Charge limit must be between 20 and 100\n");
+        } else {
+            whenAvailable(m_asusdClient, m_asusdClient->isConnected(),
+                          &AsusdClient::connectedChanged, this, [this, limit]() {
+                m_asusdClient->setChargeLimit(static_cast<quint8>(limit));
+            });
+        }
+    }
+
+    if (parser.isSet("status")) {
+        any = true;
+        reply += status();
+    }
+
+    if (!reply.isEmpty()) {
+        qDebug().noquote() << "RemoteControl:" << reply.trimmed();
+    }
+    if (acted) *acted = any;
+    return reply;
+}
+
+QString RemoteControl::status() const
+{
+    QStringList fans;
+    for (int rpm : m_systemMonitor->fanRpms()) {
+        fans << QString::number(rpm);
+    }
+
+    QString text;
+    text += QString("profile: %1\n").arg(m_performanceController->isAvailable()
+        ? m_performanceController->currentProfileName() : QString("unavailable"));
+    text += QString("gpu-mode: %1\n").arg(m_gpuController->isAvailable()
+        ? m_gpuController->currentModeName() : QString("unavailable"));
+    if (!m_gpuController->gpuPower().isEmpty()) {
+        text += QString("gpu-power: %1\n").arg(m_gpuController->gpuPower());
+    }
+    text += QString("charge-limit: %1\n").arg(m_asusdClient->isConnected()
+        ? QString::number(m_asusdClient->chargeLimit()) : QString("unavailable"));
+    text += QString("cpu-temp: %1 C\n").arg(m_systemMonitor->cpuTemp());
+    text += QString("gpu-temp: %1 C\n").arg(m_systemMonitor->gpuTemp());
+    text += QString("fans: %1 rpm\n").arg(fans.isEmpty() ? QString("-") : fans.join(' '));
+    return text;
+}
@@ -0,0 +1,57 @@
+#ifndef REMOTECONTROL_H
+#define REMOTECONTROL_H
+
+#include <QObject>
+#include <QStringList>
+
+class QCommandLineParser;
+class AsusdClient;
+class PerformanceController;
+class GpuController;
+class SystemMonitor;
+
+// Command-line control of a running instance, shared by the GUI and the
+// headless daemon. The same options work at startup and when a later launch
+// forwards them over the SingleInstance socket:
+//
+//   --profile silent|balanced|turbo   --gpu-mode eco|standard|ultimate|optimized
+//   --charge-limit 20..100            --status
+//
+// Changes that arrive before the daemon behind a controller has answered
+// are held and applied once it becomes available.
+class RemoteControl : public QObject
+{
+    Q_OBJECT
+
+public:
+    RemoteControl(AsusdClient *asusdClient,
+                  PerformanceController *performanceController,
+                  GpuController *gpuController,
+                  SystemMonitor *systemMonitor,
+                  QObject *parent = nullptr);
+    ~RemoteControl() override;
+
+    // Adds the control options (and --minimized) to a parser
+    static void addOptions(QCommandLineParser &parser);
+
+    // Applies the options set on an already parsed parser. Returns the text
+    // for the caller; *acted is set when any control option was present.
+    QString execute(const QCommandLineParser &parser, bool *acted = nullptr);
+
+    // Same for raw arguments (without the program name)
+    QString execute(const QStringList &arguments, bool *acted = nullptr);
+
+    // -1 if the name is not a profile / GPU mode
+    static int profileFromName(const QString &name);
+    static int gpuModeFromName(const QString &name);
+
+    QString status() const;
+
+private:
+    AsusdClient *m_asusdClient;
+    PerformanceController *m_performanceController;
+    GpuController *m_gpuController;
+    SystemMonitor *m_systemMonitor;
+};
+
+#endif // REMOTECONTROL_H
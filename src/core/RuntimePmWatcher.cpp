@@ -0,0 +1,100 @@
+#include "RuntimePmWatcher.h"
+#include <QDebug>
+#include <QDir>
+#include <QSocketNotifier>
+
+RuntimePmWatcher::RuntimePmWatcher(QObject *parent)
+    : QObject(parent)
+{
+    rescan();
+}
+
+RuntimePmWatcher::~RuntimePmWatcher()
+{
+    close();
+}
+
+void RuntimePmWatcher::rescan()
+{
+    const QString device = findDiscreteGpu();
+    if (device == m_devicePath && isAvailable()) return;
+
+    close();
+    if (device.isEmpty()) {
+        qDebug() << "RuntimePmWatcher: No discrete GPU with runtime PM found";
+        return;
+    }
+    open(device);
+}
+
+void RuntimePmWatcher::open(const QString &devicePath)
+{
+    m_file.setFileName(devicePath + "/power/runtime_status");
+    if (!m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        qWarning() << "RuntimePmWatcher: Cannot open" << m_file.fileName();
+        return;
+    }
+    m_devicePath = devicePath;
+    qDebug() << "RuntimePmWatcher: Watching" << m_file.fileName();
+
+    // sysfs signals attribute changes as an exceptional condition (POLLPRI)
+    m_notifier = new QSocketNotifier(m_file.handle(), QSocketNotifier::Exception, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, [this]() {
+        readStatus();
+    });
+
+    // The first read also arms the notification
+    readStatus();
+}
+
+void RuntimePmWatcher::close()
+{
+    delete m_notifier;
+    m_notifier = nullptr;
+    m_file.close();
+    m_devicePath.clear();
+}
+
+QString RuntimePmWatcher::readStatus()
+{
+    if (!isAvailable()) return m_status;
+
+    // sysfs attributes have to be re-read from the start
+    if (!m_file.seek(0)) {
+        // Device left the bus (e.g. dGPU disabled); stop watching a dead node
+        close();
+        return m_status;
+    }
+    const QString status = QString::fromLatin1(m_file.readAll()).trimmed();
+    if (status.isEmpty()) {
+        close();
+        return m_status;
+    }
+
+    if (m_status != status) {
+        m_status = status;
+        emit statusChanged(status);
+    }
+    return m_status;
+}
+
+QString RuntimePmWatcher::findDiscreteGpu()
+{
+    // A display controller that did not boot the console and has runtime PM
+    QDir pciDir("/sys/bus/pci/devices");
+    for (const QString &device : pciDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        const QString basePath = pciDir.filePath(device);
+
+        QFile classFile(basePath + "/class");
+        if (!classFile.open(QIODevice::ReadOnly)) continue;
+        if (!classFile.readAll().trimmed().startsWith("0x03")) continue;
+
+        QFile bootVgaFile(basePath + "/boot_vga");
+        if (bootVgaFile.open(QIODevice::ReadOnly) && bootVgaFile.readAll().trimmed() == "1") continue;
+
+        if (QFile::exists(basePath + "/power/runtime_status")) {
+            return basePath;
+        }
+    }
+    return QString();
+}
@@ -0,0 +1,52 @@
+#ifndef RUNTIMEPMWATCHER_H
+#define RUNTIMEPMWATCHER_H
+
+#include <QObject>
+#include <QFile>
+#include <QString>
+
+class QSocketNotifier;
+
+// Runtime power state of the discrete GPU, read from
+// /sys/bus/pci/devices/<dGPU>/power/runtime_status.
+//
+// The attribute is kept open and watched for POLLPRI, so kernels and drivers
+// that sysfs_notify() it are followed without any timer. Where they don't,
+// readStatus() is a local file read: far cheaper than a D-Bus round trip to
+// supergfxd, which makes it the fallback poll of choice.
+class RuntimePmWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RuntimePmWatcher(QObject *parent = nullptr);
+    ~RuntimePmWatcher() override;
+
+    // False when no discrete GPU with runtime PM was found (or it is
+    // currently powered off / removed from the bus)
+    bool isAvailable() const { return m_file.isOpen(); }
+    QString devicePath() const { return m_devicePath; }
+
+    // "active", "suspended", "suspending", "resuming" or "unsupported"
+    QString status() const { return m_status; }
+
+    // Re-reads the attribute; emits statusChanged when it differs
+    QString readStatus();
+    // Looks for the dGPU again, e.g. after a mode switch put it back on the bus
+    void rescan();
+
+signals:
+    void statusChanged(const QString &status);
+
+private:
+    void open(const QString &devicePath);
+    void close();
+    static QString findDiscreteGpu();
+
+    QString m_devicePath;
+    QFile m_file;
+    QSocketNotifier *m_notifier = nullptr;
+    QString m_status;
+};
+
+#endif // RUNTIMEPMWATCHER_H
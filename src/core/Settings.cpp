@@ -57,6 +57,17 @@ void Settings::setMinimizeToTray(bool value)
     }
 }
 
+int Settings::trayIconContent() const { return m_trayIconContent; }
+void Settings::setTrayIconContent(int value)
+{
+    value = qBound(0, value, 2);
+    if (m_trayIconContent != value) {
+        m_trayIconContent = value;
+        emit trayIconContentChanged();
+        save();
+    }
+}
+
 int Settings::windowX() const { return m_windowX; }
 void Settings::setWindowX(int value)
 {
@@ -75,6 +86,17 @@ void Settings::setWindowY(int value)
     }
 }
 
+int Settings::uiUnloadDelay() const { return m_uiUnloadDelay; }
+void Settings::setUiUnloadDelay(int value)
+{
+    value = qMax(0, value);
+    if (m_uiUnloadDelay != value) {
+        m_uiUnloadDelay = value;
+        emit uiUnloadDelayChanged();
+        save();
+    }
+}
+
 int Settings::defaultPerformanceProfile() const { return m_defaultPerformanceProfile; }
 void Settings::setDefaultPerformanceProfile(int value)
 {
@@ -95,18 +117,31 @@ void Settings::setDefaultGpuMode(int value)
     }
 }
 
+int Settings::fanRpmLimit() const { return m_fanRpmLimit; }
+void Settings::setFanRpmLimit(int value)
+{
+    value = qMax(0, value);
+    if (m_fanRpmLimit != value) {
+        m_fanRpmLimit = value;
+        emit fanRpmLimitChanged();
+        save();
+    }
+}
+
 void Settings::save()
 {
     m_settings.beginGroup("Window");
     m_settings.setValue("startMinimized", m_startMinimized);
     m_settings.setValue("x", m_windowX);
     m_settings.setValue("y", m_windowY);
+    m_settings.setValue("unloadDelay", m_uiUnloadDelay);
     m_settings.endGroup();
 
     m_settings.beginGroup("General");
     m_settings.setValue("autoStart", m_autoStart);
     m_settings.setValue("showTrayIcon", m_showTrayIcon);
     m_settings.setValue("minimizeToTray", m_minimizeToTray);
+    m_settings.setValue("trayIconContent", m_trayIconContent);
     m_settings.endGroup();
 
     m_settings.beginGroup("Defaults");
@@ -114,6 +149,10 @@ void Settings::save()
     m_settings.setValue("gpuMode", m_defaultGpuMode);
     m_settings.endGroup();
 
+    m_settings.beginGroup("Acoustic");
+    m_settings.setValue("fanRpmLimit", m_fanRpmLimit);
+    m_settings.endGroup();
+
     m_settings.sync();
 }
 
@@ -123,18 +162,24 @@ void Settings::load()
     m_startMinimized = m_settings.value("startMinimized", false).toBool();
     m_windowX = m_settings.value("x", -1).toInt();
     m_windowY = m_settings.value("y", -1).toInt();
+    m_uiUnloadDelay = m_settings.value("unloadDelay", 60).toInt();
     m_settings.endGroup();
 
     m_settings.beginGroup("General");
     m_autoStart = m_settings.value("autoStart", false).toBool();
     m_showTrayIcon = m_settings.value("showTrayIcon", true).toBool();
     m_minimizeToTray = m_settings.value("minimizeToTray", true).toBool();
+    m_trayIconContent = qBound(0, m_settings.value("trayIconContent", 0).toInt(), 2);
     m_settings.endGroup();
 
     m_settings.beginGroup("Defaults");
     m_defaultPerformanceProfile = m_settings.value("performanceProfile", 1).toInt();
     m_defaultGpuMode = m_settings.value("gpuMode", 1).toInt();
     m_settings.endGroup();
+
+    m_settings.beginGroup("Acoustic");
+    m_fanRpmLimit = m_settings.value("fanRpmLimit", 0).toInt();
+    m_settings.endGroup();
 }
 
 void Settings::resetToDefaults()
@@ -143,19 +188,25 @@ void Settings::resetToDefaults()
     m_autoStart = false;
     m_showTrayIcon = true;
     m_minimizeToTray = true;
+    m_trayIconContent = 0;
     m_windowX = -1;
     m_windowY = -1;
+    m_uiUnloadDelay = 60;
     m_defaultPerformanceProfile = 1;
     m_defaultGpuMode = 1;
+    m_fanRpmLimit = 0;
 
     emit startMinimizedChanged();
     emit autoStartChanged();
     emit showTrayIconChanged();
     emit minimizeToTrayChanged();
+    emit trayIconContentChanged();
     emit windowXChanged();
     emit windowYChanged();
+    emit uiUnloadDelayChanged();
     emit defaultPerformanceProfileChanged();
     emit defaultGpuModeChanged();
+    emit fanRpmLimitChanged();
 
     save();
 }
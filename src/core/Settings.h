@@ -3,7 +3,6 @@
 
 #include <QObject>
 #include <QSettings>
-#include <QColor>
 
 class Settings : public QObject
 {
@@ -12,10 +11,13 @@ class Settings : public QObject
     Q_PROPERTY(bool autoStart READ autoStart WRITE setAutoStart NOTIFY autoStartChanged)
     Q_PROPERTY(bool showTrayIcon READ showTrayIcon WRITE setShowTrayIcon NOTIFY showTrayIconChanged)
     Q_PROPERTY(bool minimizeToTray READ minimizeToTray WRITE setMinimizeToTray NOTIFY minimizeToTrayChanged)
+    Q_PROPERTY(int trayIconContent READ trayIconContent WRITE setTrayIconContent NOTIFY trayIconContentChanged)
     Q_PROPERTY(int windowX READ windowX WRITE setWindowX NOTIFY windowXChanged)
     Q_PROPERTY(int windowY READ windowY WRITE setWindowY NOTIFY windowYChanged)
+    Q_PROPERTY(int uiUnloadDelay READ uiUnloadDelay WRITE setUiUnloadDelay NOTIFY uiUnloadDelayChanged)
     Q_PROPERTY(int defaultPerformanceProfile READ defaultPerformanceProfile WRITE setDefaultPerformanceProfile NOTIFY defaultPerformanceProfileChanged)
     Q_PROPERTY(int defaultGpuMode READ defaultGpuMode WRITE setDefaultGpuMode NOTIFY defaultGpuModeChanged)
+    Q_PROPERTY(int fanRpmLimit READ fanRpmLimit WRITE setFanRpmLimit NOTIFY fanRpmLimitChanged)
 
 public:
     explicit Settings(QObject *parent = nullptr);
@@ -34,12 +36,20 @@ public:
     bool minimizeToTray() const;
     void setMinimizeToTray(bool value);
 
+    // What the tray icon shows: 0 = logo, 1 = CPU temperature, 2 = power draw
+    int trayIconContent() const;
+    void setTrayIconContent(int value);
+
     int windowX() const;
     void setWindowX(int value);
 
     int windowY() const;
     void setWindowY(int value);
 
+    // Seconds the window may stay hidden before its UI is unloaded (0 = never)
+    int uiUnloadDelay() const;
+    void setUiUnloadDelay(int value);
+
     // Default settings
     int defaultPerformanceProfile() const;
     void setDefaultPerformanceProfile(int value);
@@ -47,6 +57,10 @@ public:
     int defaultGpuMode() const;
     void setDefaultGpuMode(int value);
 
+    // Acoustic budget (0 = no limit)
+    int fanRpmLimit() const;
+    void setFanRpmLimit(int value);
+
     Q_INVOKABLE void save();
     Q_INVOKABLE void load();
     Q_INVOKABLE void resetToDefaults();
@@ -56,10 +70,13 @@ signals:
     void autoStartChanged();
     void showTrayIconChanged();
     void minimizeToTrayChanged();
+    void trayIconContentChanged();
     void windowXChanged();
     void windowYChanged();
+    void uiUnloadDelayChanged();
     void defaultPerformanceProfileChanged();
     void defaultGpuModeChanged();
+    void fanRpmLimitChanged();
 
 private:
     void setupAutostart(bool enable);
@@ -70,10 +87,13 @@ private:
     bool m_autoStart = false;
     bool m_showTrayIcon = true;
     bool m_minimizeToTray = true;
+    int m_trayIconContent = 0;
     int m_windowX = -1;
     int m_windowY = -1;
+    int m_uiUnloadDelay = 60;
     int m_defaultPerformanceProfile = 1; // Balanced
     int m_defaultGpuMode = 1; // Hybrid
+    int m_fanRpmLimit = 0;
 };
 
 #endif // SETTINGS_H
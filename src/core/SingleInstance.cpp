@@ -0,0 +1,206 @@
+#include "SingleInstance.h"
+#include <QDebug>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Plain POSIX so a forwarding launch needs no Qt objects at all
+std::string socketPathNative()
+{
+    if (const char *runtimeDir = std::getenv("XDG_RUNTIME_DIR"); runtimeDir && *runtimeDir) {
+        return std::string(runtimeDir) + "/g-helper-linux.sock";
+    }
+    // No runtime dir (e.g. started outside a login session): per-user name in /tmp
+    return "/tmp/g-helper-linux-" + std::to_string(getuid()) + ".sock";
+}
+
+bool writeAll(int fd, const char *data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+// A complete request: the argument count, then that many arguments.
+// False while more data is still to come.
+bool parseRequest(const QByteArray &data, QStringList *arguments)
+{
+    quint32 count = 0;
+    if (data.size() < qsizetype(sizeof(count))) return false;
+    std::memcpy(&count, data.constData(), sizeof(count));
+
+    QStringList parsed;
+    qsizetype from = sizeof(count);
+    while (quint32(parsed.size()) < count) {
+        const qsizetype end = data.indexOf('\0', from);
+        if (end < 0) return false;
+        parsed << QString::fromUtf8(data.constData() + from, end - from);
+        from = end + 1;
+    }
+    *arguments = parsed;
+    return true;
+}
+
+} // namespace
+
+SingleInstance::SingleInstance(QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+{
+    // Only this user may talk to us
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+}
+
+SingleInstance::~SingleInstance() = default;
+
+QString SingleInstance::socketPath()
+{
+    return QString::fromStdString(socketPathNative());
+}
+
+bool SingleInstance::forward(int argc, char *argv[])
+{
+    const std::string path = socketPathNative();
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) return false;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+
+    // A wedged instance must not hang this launch: a timeout counts as
+    // nobody running
+    const timeval timeout{0, IO_TIMEOUT_MS * 1000};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // Refused or missing: nobody is running (a stale socket file is
+    // cleaned up by listen())
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // One write: the count says where the request ends, so the socket
+    // stays open for the reply (no half-close, which QLocalSocket cannot see)
+    const quint32 count = static_cast<quint32>(argc > 1 ? argc - 1 : 0);
+    std::string request(reinterpret_cast<const char *>(&count), sizeof(count));
+    for (int i = 1; i < argc; i++) {
+        request.append(argv[i], std::strlen(argv[i]) + 1);
+    }
+    bool ok = writeAll(fd, request.data(), request.size());
+
+    // Reply up to the terminating NUL; without it the instance died on us
+    std::string reply;
+    char buffer[512];
+    while (ok && (reply.empty() || reply.back() != '\0')) {
+        const ssize_t received = ::read(fd, buffer, sizeof(buffer));
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) break;
+        reply.append(buffer, static_cast<size_t>(received));
+    }
+    ::close(fd);
+
+    if (!ok || reply.empty() || reply.back() != '\0') return false;
+    reply.pop_back();
+    if (!reply.empty()) {
+        std::fwrite(reply.data(), 1, reply.size(), stdout);
+        std::fflush(stdout);
+    }
+    return true;
+}
+
+bool SingleInstance::isStandaloneLaunch(int argc, char *argv[])
+{
+    for (const char *option : {"--help", "-h", "--version", "-v", "--trace",
+                               "--startup-benchmark", "--show-benchmark"}) {
+        if (hasArgument(argc, argv, option)) return true;
+    }
+    return false;
+}
+
+bool SingleInstance::hasArgument(int argc, char *argv[], const char *name)
+{
+    const size_t length = std::strlen(name);
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], name, length) == 0
+            && (argv[i][length] == '\0' || argv[i][length] == '=')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SingleInstance::listen()
+{
+    const QString path = socketPath();
+    if (m_server->listen(path)) {
+        return true;
+    }
+
+    if (m_server->serverError() == QAbstractSocket::AddressInUseError) {
+        // Either someone else is listening or the file is left over from a crash
+        QLocalSocket probe;
+        probe.connectToServer(path);
+        if (probe.waitForConnected(100)) {
+            return false;
+        }
+        QLocalServer::removeServer(path);
+        if (m_server->listen(path)) {
+            return true;
+        }
+    }
+
+    // Carry on as an unguarded instance rather than not starting at all
+    qWarning() << "SingleInstance: Cannot listen on" << path << ":" << m_server->errorString();
+    return true;
+}
+
+void SingleInstance::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        // The request is left in the socket until all of it has arrived
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            const QByteArray data = socket->peek(socket->bytesAvailable());
+            QStringList arguments;
+            if (!parseRequest(data, &arguments)) {
+                if (data.size() > MAX_REQUEST_SIZE) {
+                    qWarning() << "SingleInstance: Oversized request, dropping it";
+                    socket->abort();
+                }
+                return;
+            }
+            socket->readAll();
+            socket->disconnect(this);
+
+            qDebug() << "SingleInstance: Arguments from a second launch:" << arguments;
+            const QByteArray reply = m_handler ? m_handler(arguments).toUtf8() : QByteArray();
+
+            // Written before the socket closes; disconnectFromServer() flushes
+            socket->write(reply);
+            socket->write("\0", 1);
+            socket->disconnectFromServer();
+        });
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QObject>
+#include <QStringList>
+#include <functional>
+
+class QLocalServer;
+
+// Keeps one g-helper-linux per user session.
+//
+// The running instance listens on a local socket in $XDG_RUNTIME_DIR. A
+// later launch calls forward() before creating any Qt application object:
+// it connects with a plain AF_UNIX socket, hands over its arguments and
+// exits, so it never initialises the GUI, QML or D-Bus.
+//
+// Wire format: the argument count (quint32, host byte order), then the
+// arguments (without argv[0]) as NUL-terminated UTF-8 strings. The server
+// answers on the same connection with the handler's reply text and a
+// terminating NUL, which the client prints to stdout, and closes it. An
+// instance that does not answer within IO_TIMEOUT_MS counts as not running.
+class SingleInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Handles the arguments of a later launch (without the program name);
+    // the returned text is printed by that launch
+    using Handler = std::function<QString(const QStringList &arguments)>;
+
+    explicit SingleInstance(QObject *parent = nullptr);
+    ~SingleInstance() override;
+
+    // Sends argv to a running instance; true if one took it over
+    static bool forward(int argc, char *argv[]);
+
+    // Help, version and diagnostic runs (--trace, the benchmarks) are
+    // answered by the launched process itself and never forwarded
+    static bool isStandaloneLaunch(int argc, char *argv[]);
+
+    // argv contains "name" or "name=value"
+    static bool hasArgument(int argc, char *argv[], const char *name);
+
+    // Becomes the running instance. False if another one won the race
+    // (its arguments should then be forwarded instead).
+    bool listen();
+
+    void setHandler(Handler handler) { m_handler = std::move(handler); }
+
+    static QString socketPath();
+
+    static constexpr int IO_TIMEOUT_MS = 500;
+
+private:
+    void onNewConnection();
+
+    static constexpr qsizetype MAX_REQUEST_SIZE = 64 * 1024;
+
+    QLocalServer *m_server;
+    Handler m_handler;
+};
+
+#endif // SINGLEINSTANCE_H
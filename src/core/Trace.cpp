@@ -0,0 +1,112 @@
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <atomic>
+#include <memory>
+
+bool Trace::s_enabled = false;
+
+namespace {
+
+struct Event {
+    const char *name;
+    const char *category;
+    qint64 startNs;
+    qint64 durationNs; // -1 for instant events
+    quintptr thread;
+};
+
+QElapsedTimer s_clock;
+std::unique_ptr<Event[]> s_events;
+std::atomic<int> s_next{0};
+std::atomic<int> s_dropped{0};
+
+Event *reserve()
+{
+    const int index = s_next.fetch_add(1, std::memory_order_relaxed);
+    if (index >= Trace::CAPACITY) {
+        s_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &s_events[index];
+}
+
+} // namespace
+
+void Trace::setEnabled(bool enabled)
+{
+    if (enabled && !s_events) {
+        s_events.reset(new Event[CAPACITY]);
+        s_clock.start();
+    }
+    s_enabled = enabled;
+}
+
+qint64 Trace::now()
+{
+    return s_clock.nsecsElapsed();
+}
+
+void Trace::complete(const char *name, const char *category, qint64 startNs, qint64 endNs)
+{
+    if (!s_enabled) return;
+    if (Event *event = reserve()) {
+        *event = {name, category, startNs, endNs - startNs,
+                  reinterpret_cast<quintptr>(QThread::currentThreadId())};
+    }
+}
+
+void Trace::instant(const char *name, const char *category)
+{
+    if (!s_enabled) return;
+    if (Event *event = reserve()) {
+        *event = {name, category, now(), -1,
+                  reinterpret_cast<quintptr>(QThread::currentThreadId())};
+    }
+}
+
+bool Trace::writeJson(const QString &path)
+{
+    if (!s_events) return false;
+
+    const int count = qMin(s_next.load(), static_cast<int>(CAPACITY));
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    // Chrome's trace_event format counts in microseconds
+    QJsonArray events;
+    for (int i = 0; i < count; i++) {
+        const Event &event = s_events[i];
+        QJsonObject json{
+            {"name", QString::fromUtf8(event.name)},
+            {"cat", QString::fromUtf8(event.category)},
+            {"ts", event.startNs / 1000.0},
+            {"pid", pid},
+            {"tid", static_cast<qint64>(event.thread)},
+        };
+        if (event.durationNs >= 0) {
+            json["ph"] = "X";
+            json["dur"] = event.durationNs / 1000.0;
+        } else {
+            json["ph"] = "i";
+            json["s"] = "t";
+        }
+        events.append(json);
+    }
+
+    QJsonObject root{
+        {"traceEvents", events},
+        {"displayTimeUnit", "ms"},
+        {"otherData", QJsonObject{{"droppedEvents", s_dropped.load()}}},
+    };
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+}
@@ -0,0 +1,71 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <QtGlobal>
+
+// Scoped startup tracing, written out as Chrome/Perfetto trace_event JSON.
+//
+// Events go into a fixed buffer allocated once; recording takes a timestamp
+// and one atomic increment, and events past the capacity are counted and
+// dropped. Names and categories must be string literals (only the pointer
+// is stored). With tracing disabled every entry point is a single branch.
+//
+// Open the output in ui.perfetto.dev or chrome://tracing.
+class Trace
+{
+public:
+    // Starts the clock (call first thing in main) and allocates the buffer
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return s_enabled; }
+
+    // Nanoseconds since setEnabled(true)
+    static qint64 now();
+
+    // An already measured interval, e.g. the life of an async call
+    static void complete(const char *name, const char *category, qint64 startNs, qint64 endNs);
+    static void instant(const char *name, const char *category);
+
+    // Writes all recorded events; false if the file could not be written
+    static bool writeJson(const QString &path);
+
+    // Records the lifetime of the enclosing scope
+    class Span
+    {
+    public:
+        explicit Span(const char *name, const char *category = "startup")
+            : m_name(name)
+            , m_category(category)
+            , m_start(s_enabled ? now() : -1)
+        {
+        }
+
+        ~Span()
+        {
+            if (m_start >= 0) {
+                complete(m_name, m_category, m_start, now());
+            }
+        }
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *m_name;
+        const char *m_category;
+        qint64 m_start;
+    };
+
+    // Events kept per run; startup records a few hundred
+    static constexpr int CAPACITY = 8192;
+
+private:
+    static bool s_enabled;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+// TRACE_SPAN("name") or TRACE_SPAN("name", "category")
+#define TRACE_SPAN(...) Trace::Span TRACE_CONCAT(traceSpan_, __LINE__)(__VA_ARGS__)
+
+#endif // TRACE_H
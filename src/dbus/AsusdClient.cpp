@@ -1,14 +1,19 @@
 #include "AsusdClient.h"
+#include "SystemBus.h"
+#include "DBusPropertySync.h"
+#include "AuraDeviceRegistry.h"
+#include "Trace.h"
+#include "fancurvesproxy.h"
 #include <QDBusPendingReply>
-#include <QDBusReply>
 #include <QDebug>
-#include <QRegularExpression>
-#include <QProcess>
-#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <memory>
 
 AsusdClient::AsusdClient(QObject *parent)
     : QObject(parent)
 {
+    TRACE_SPAN("AsusdClient", "dbus");
     registerDBusTypes();
     setupConnections();
 }
@@ -17,147 +22,182 @@ AsusdClient::~AsusdClient() = default;
 
 void AsusdClient::setupConnections()
 {
-    QDBusConnection bus = QDBusConnection::systemBus();
+    // Never block on the daemon: ask the bus whether it is there and carry on
+    SystemBus::probeService(SERVICE, this, [this](bool available) {
+        if (available) {
+            onServiceAvailable();
+        }
+    });
+}
+
+void AsusdClient::reconnect()
+{
+    if (m_connected) return;
+    setupConnections();
+}
 
-    m_platformInterface = new QDBusInterface(
-        SERVICE, PATH_PLATFORM, "org.freedesktop.DBus.Properties", bus, this);
+void AsusdClient::serviceLost()
+{
+    // A restarted asusd may hold different curves than we last wrote
+    invalidateFanCurveCache();
+    if (!m_connected) return;
 
-    m_connected = m_platformInterface->isValid();
+    m_connected = false;
+    m_pendingWrites.clear();
+    m_hasQueuedLedMode = false;
+    // Device nodes come back (possibly different ones) with the daemon
+    m_auraDevices->clear();
+    emit connectedChanged(false);
+}
 
-    if (m_connected) {
-        // Connect to PropertiesChanged signal
-        bus.connect(SERVICE, PATH_PLATFORM, "org.freedesktop.DBus.Properties",
-                    "PropertiesChanged", this, SLOT(onPropertiesChanged(QString, QVariantMap, QStringList)));
+void AsusdClient::onServiceAvailable()
+{
+    if (m_connected) return;
 
-        refresh();
+    m_connected = true;
+    if (!m_fanCurves) {
+        m_fanCurves = new FanCurvesProxy(SERVICE, PATH_PLATFORM, SystemBus::connection(), this);
+    }
+    if (!m_platformSync) {
+        m_platformSync = new DBusPropertySync(SERVICE, PATH_PLATFORM, INTERFACE_PLATFORM, this);
+        connect(m_platformSync, &DBusPropertySync::propertiesUpdated,
+                this, &AsusdClient::onPlatformPropertiesUpdated);
     }
+    if (!m_auraDevices) {
+        m_auraDevices = new AuraDeviceRegistry(SERVICE, this);
+        connect(m_auraDevices, &AuraDeviceRegistry::deviceAdded,
+                this, &AsusdClient::onAuraDeviceAdded);
+        connect(m_auraDevices, &AuraDeviceRegistry::scanFinished,
+                this, &AsusdClient::onAuraScanFinished);
+        connect(m_auraDevices, &AuraDeviceRegistry::devicesChanged, this, [this]() {
+            // The primary device may have changed; show its state
+            if (DBusPropertySync *primary = m_auraDevices->primary(); primary && primary->isPopulated()) {
+                onAuraPropertiesUpdated(primary->values());
+            }
+            emit auraDevicesChanged();
+        });
+    }
+
+    emit connectedChanged(true);
+    refresh();
 }
 
 void AsusdClient::refresh()
 {
     if (!m_connected) return;
 
-    fetchPlatformProfile();
-    fetchChargeLimit();
-    fetchLedBrightness();
+    // Coalesced: controllers refreshing back to back share one GetAll each
+    m_platformSync->refresh();
+
+    // No-op once the devices are known, or while a recent scan found none
+    m_auraDevices->discover();
+    for (DBusPropertySync *device : m_auraDevices->targets()) {
+        device->refresh();
+    }
+
+    // Seed the fan curve shadow with what asusd actually holds, so curves
+    // that are already programmed are not written again
+    for (quint32 profile = 0; profile < FAN_PROFILES; profile++) {
+        readFanCurves(profile);
+    }
 }
 
-void AsusdClient::fetchPlatformProfile()
+QStringList AsusdClient::auraDevices() const
 {
-    QDBusPendingCall call = m_platformInterface->asyncCall("Get", INTERFACE_PLATFORM, "PlatformProfile");
-    auto *watcher = new QDBusPendingCallWatcher(call, this);
-    connect(watcher, &QDBusPendingCallWatcher::finished,
-            this, &AsusdClient::onPlatformProfileResult);
+    return m_auraDevices ? m_auraDevices->devices() : QStringList();
 }
 
-void AsusdClient::onPlatformProfileResult(QDBusPendingCallWatcher *watcher)
+void AsusdClient::onAuraDeviceAdded(const QString &node, DBusPropertySync *device)
 {
-    QDBusPendingReply<QDBusVariant> reply = *watcher;
-    if (reply.isError()) {
-        qWarning() << "Failed to get platform profile:" << reply.error().message();
-    } else {
-        quint32 profile = reply.value().variant().toUInt();
-        if (m_platformProfile != profile) {
-            m_platformProfile = profile;
-            emit platformProfileChanged(profile);
+    Q_UNUSED(node)
+    // Only the primary device drives ledBrightness
+    connect(device, &DBusPropertySync::propertiesUpdated, this, [this, device](const QVariantMap &changed) {
+        if (device == m_auraDevices->primary()) {
+            onAuraPropertiesUpdated(changed);
         }
+    });
+}
+
+void AsusdClient::onAuraScanFinished(bool found)
+{
+    if (!m_hasQueuedLedMode) return;
+    m_hasQueuedLedMode = false;
+
+    // A mode picked before the devices were known
+    if (found) {
+        sendLedMode(m_queuedLedMode, m_queuedLedDevice);
     }
-    watcher->deleteLater();
 }
 
 void AsusdClient::setPlatformProfile(quint32 profile)
 {
-    // Convert profile number to name
-    QString profileName;
-    switch (profile) {
-        case 0: profileName = "Quiet"; break;
-        case 1: profileName = "Balanced"; break;
-        case 2: profileName = "Performance"; break;
-        default:
-            qWarning() << "AsusdClient: Invalid profile:" << profile;
-            return;
+    if (!m_connected) return;
+
+    if (profileName(profile).isEmpty()) {
+        qWarning() << "AsusdClient: Invalid profile:" << profile;
+        return;
     }
 
-    // Update local state immediately and ignore D-Bus updates for a bit
+    // UI already updated by PerformanceController; the echo is reconciled
+    // against this write rather than ignored for a fixed time
     m_platformProfile = profile;
-    m_ignoringProfileUpdates = true;
-    m_profileSetTimer.start();
-
-    // Run asusctl asynchronously - UI already updated by PerformanceController
-    QProcess *process = new QProcess(this);
-    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [this, process, profileName](int exitCode, QProcess::ExitStatus) {
-        if (exitCode != 0) {
-            QString error = QString::fromUtf8(process->readAllStandardError());
-            qWarning() << "AsusdClient: Failed to set profile:" << error;
+    const quint64 generation = m_pendingWrites.begin("PlatformProfile", profile);
+
+    setDBusProperty(LatencyStats::SetPlatformProfile, m_platformSync,
+                    "PlatformProfile", QVariant::fromValue(profile), [this, generation](const QDBusError &error) {
+        if (error.isValid()) {
+            qWarning() << "AsusdClient: Failed to set profile:" << error.message();
+            writeFailed(m_platformSync, "PlatformProfile", generation);
             emit errorOccurred(tr("Failed to set performance profile"));
+        } else {
+            m_pendingWrites.acknowledge("PlatformProfile", generation);
         }
-        // Stop ignoring after command completes (with small delay for D-Bus)
-        QTimer::singleShot(500, this, [this]() {
-            m_ignoringProfileUpdates = false;
-        });
-        process->deleteLater();
     });
-
-    process->start("asusctl", QStringList{"profile", "set", profileName});
 }
 
-void AsusdClient::onPropertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated)
+void AsusdClient::onPlatformPropertiesUpdated(const QVariantMap &changed)
 {
-    Q_UNUSED(invalidated)
-
-    if (interface == INTERFACE_PLATFORM) {
-        if (changed.contains("PlatformProfile")) {
-            // Ignore D-Bus updates if we recently set the profile ourselves
-            if (!m_ignoringProfileUpdates) {
-                quint32 profile = changed["PlatformProfile"].toUInt();
-                if (m_platformProfile != profile) {
-                    m_platformProfile = profile;
-                    emit platformProfileChanged(profile);
-                }
-            }
-        }
-        if (changed.contains("ChargeControlEndThreshold")) {
-            quint8 limit = static_cast<quint8>(changed["ChargeControlEndThreshold"].toUInt());
-            if (m_chargeLimit != limit) {
-                m_chargeLimit = limit;
-                emit chargeLimitChanged(limit);
-            }
+    if (changed.contains("PlatformProfile")
+        && m_pendingWrites.reconcile("PlatformProfile", changed["PlatformProfile"]) == PendingWriteTracker::Apply) {
+        quint32 profile = changed["PlatformProfile"].toUInt();
+        if (m_platformProfile != profile) {
+            m_platformProfile = profile;
+            emit platformProfileChanged(profile);
         }
-    } else if (interface == INTERFACE_AURA) {
-        if (changed.contains("Brightness")) {
-            quint32 brightness = changed["Brightness"].toUInt();
-            if (m_ledBrightness != brightness) {
-                m_ledBrightness = brightness;
-                emit ledBrightnessChanged(brightness);
-            }
+    }
+    if (changed.contains("ChargeControlEndThreshold")
+        && m_pendingWrites.reconcile("ChargeControlEndThreshold", changed["ChargeControlEndThreshold"]) == PendingWriteTracker::Apply) {
+        quint8 limit = static_cast<quint8>(changed["ChargeControlEndThreshold"].toUInt());
+        if (m_chargeLimit != limit) {
+            m_chargeLimit = limit;
+            emit chargeLimitChanged(limit);
         }
     }
 }
 
-void AsusdClient::fetchChargeLimit()
+void AsusdClient::onAuraPropertiesUpdated(const QVariantMap &changed)
 {
-    if (!m_connected) return;
-
-    QDBusPendingCall call = m_platformInterface->asyncCall("Get", INTERFACE_PLATFORM, "ChargeControlEndThreshold");
-    auto *watcher = new QDBusPendingCallWatcher(call, this);
-    connect(watcher, &QDBusPendingCallWatcher::finished,
-            this, &AsusdClient::onChargeLimitResult);
+    if (changed.contains("Brightness")
+        && m_pendingWrites.reconcile("Brightness", changed["Brightness"]) == PendingWriteTracker::Apply) {
+        quint32 brightness = changed["Brightness"].toUInt();
+        if (m_ledBrightness != brightness) {
+            m_ledBrightness = brightness;
+            emit ledBrightnessChanged(brightness);
+        }
+    }
 }
 
-void AsusdClient::onChargeLimitResult(QDBusPendingCallWatcher *watcher)
+void AsusdClient::writeFailed(DBusPropertySync *sync, const QString &name, quint64 generation)
 {
-    QDBusPendingReply<QDBusVariant> reply = *watcher;
-    if (reply.isError()) {
-        qWarning() << "Failed to get charge limit:" << reply.error().message();
-    } else {
-        quint8 limit = static_cast<quint8>(reply.value().variant().toUInt());
-        if (m_chargeLimit != limit) {
-            m_chargeLimit = limit;
-            emit chargeLimitChanged(limit);
+    // Nothing newer in flight: fall back to what the daemon last reported
+    if (m_pendingWrites.fail(name, generation) && sync && sync->values().contains(name)) {
+        const QVariantMap authoritative{{name, sync->value(name)}};
+        if (m_auraDevices && sync == m_auraDevices->primary()) {
+            onAuraPropertiesUpdated(authoritative);
+        } else {
+            onPlatformPropertiesUpdated(authoritative);
         }
     }
-    watcher->deleteLater();
 }
 
 void AsusdClient::setChargeLimit(quint8 limit)
@@ -166,253 +206,389 @@ void AsusdClient::setChargeLimit(quint8 limit)
 
     qDebug() << "AsusdClient: Setting charge limit to" << limit;
 
-    // Use busctl for reliable property setting - async to not block UI
-    QStringList args;
-    args << "set-property"
-         << SERVICE
-         << PATH_PLATFORM
-         << INTERFACE_PLATFORM
-         << "ChargeControlEndThreshold"
-         << "y"
-         << QString::number(limit);
-
-    QProcess *process = new QProcess(this);
-    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [this, process, limit](int exitCode, QProcess::ExitStatus) {
-        if (exitCode != 0) {
-            qWarning() << "Failed to set charge limit:" << process->readAllStandardError();
+    if (m_chargeLimit != limit) {
+        m_chargeLimit = limit;
+        emit chargeLimitChanged(limit);
+    }
+    const quint64 generation = m_pendingWrites.begin("ChargeControlEndThreshold", limit);
+
+    // ChargeControlEndThreshold is a byte ("y"); quint8 marshals as such
+    setDBusProperty(LatencyStats::SetChargeLimit, m_platformSync,
+                    "ChargeControlEndThreshold", QVariant::fromValue(limit), [this, generation](const QDBusError &error) {
+        if (error.isValid()) {
+            qWarning() << "Failed to set charge limit:" << error.message();
+            writeFailed(m_platformSync, "ChargeControlEndThreshold", generation);
             emit errorOccurred(tr("Failed to set charge limit"));
         } else {
             qDebug() << "AsusdClient: Charge limit set successfully";
-            m_chargeLimit = limit;
-            emit chargeLimitChanged(limit);
+            m_pendingWrites.acknowledge("ChargeControlEndThreshold", generation);
         }
-        process->deleteLater();
     });
+}
+
+void AsusdClient::setLedBrightness(quint32 level, const QString &device)
+{
+    if (!m_connected || m_auraDevices->targets(device).isEmpty()) return;
+
+    // ledBrightness mirrors the primary device; writes to other devices
+    // alone are not tracked against its echo
+    QPointer<DBusPropertySync> primary = m_auraDevices->primary();
+    const bool tracksPrimary = m_auraDevices->targets(device).contains(primary.data());
+    quint64 generation = 0;
+    if (tracksPrimary) {
+        if (m_ledBrightness != level) {
+            m_ledBrightness = level;
+            emit ledBrightnessChanged(level);
+        }
+        generation = m_pendingWrites.begin("Brightness", level);
+    }
+
+    setAuraProperty(LatencyStats::SetLedBrightness, device,
+                    "Brightness", QVariant::fromValue(level), [this, primary, tracksPrimary, generation](const QDBusError &error) {
+        if (error.isValid()) {
+            qWarning() << "Failed to set LED brightness:" << error.message();
+            if (tracksPrimary) writeFailed(primary, "Brightness", generation);
+            emit errorOccurred(tr("Failed to set LED brightness: %1").arg(error.message()));
+        } else if (tracksPrimary) {
+            m_pendingWrites.acknowledge("Brightness", generation);
+        }
+    });
+}
 
-    process->start("busctl", args);
+void AsusdClient::setLedMode(quint32 mode, const AuraColor &color1, const AuraColor &color2, quint8 speed,
+                             const QString &device)
+{
+    if (!m_connected) return;
+
+    qDebug() << "AsusdClient: Setting LED mode" << mode << "color1:"
+             << color1.red << color1.green << color1.blue;
+
+    AuraEffect effect;
+    effect.mode = mode;
+    effect.zone = 0; // All zones
+    effect.color1 = color1;
+    effect.color2 = color2;
+    effect.speed = speed == 0 ? "Low" : (speed == 2 ? "High" : "Med");
+    effect.direction = "Right";
+
+    if (m_auraDevices->targets(device).isEmpty()) {
+        // A recent scan already said no, or the named device isn't among
+        // the known ones: don't pay another round trip to hear it again
+        if (m_auraDevices->isKnownAbsent() || !m_auraDevices->devices().isEmpty()) {
+            qWarning() << "AsusdClient: No Aura device" << device;
+            return;
+        }
+
+        // Sent once the device scan completes; only the latest pick matters
+        m_queuedLedMode = effect;
+        m_queuedLedDevice = device;
+        m_hasQueuedLedMode = true;
+        m_auraDevices->discover();
+        return;
+    }
+
+    sendLedMode(effect, device);
 }
 
-void AsusdClient::findAuraDevice()
+void AsusdClient::sendLedMode(const AuraEffect &effect, const QString &device)
 {
-    // Find the aura device path dynamically
-    QDBusMessage msg = QDBusMessage::createMethodCall(
-        "org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus", "ListNames");
-
-    QDBusConnection bus = QDBusConnection::systemBus();
-
-    // Try to introspect to find aura path
-    QDBusMessage introMsg = QDBusMessage::createMethodCall(
-        SERVICE, "/xyz/ljones/aura", "org.freedesktop.DBus.Introspectable", "Introspect");
-
-    QDBusReply<QString> introReply = bus.call(introMsg);
-    if (introReply.isValid()) {
-        QString xml = introReply.value();
-        // Parse to find child nodes like "19b6_3_4"
-        QRegularExpression re("node name=\"([^\"]+)\"");
-        QRegularExpressionMatch match = re.match(xml);
-        if (match.hasMatch()) {
-            m_auraPath = "/xyz/ljones/aura/" + match.captured(1);
-            m_auraInterface = new QDBusInterface(
-                SERVICE, m_auraPath, "org.freedesktop.DBus.Properties", bus, this);
+    // Marshalled as (uu(yyy)(yyy)ss) through the registered AuraEffect type
+    setAuraProperty(LatencyStats::SetLedMode, device,
+                    "LedModeData", QVariant::fromValue(effect), [this](const QDBusError &error) {
+        if (error.isValid()) {
+            qWarning() << "Failed to set LED mode:" << error.message();
+            emit errorOccurred(tr("Failed to set LED mode"));
+        } else {
+            qDebug() << "AsusdClient: LED mode set successfully";
         }
+    });
+}
+
+void AsusdClient::setAuraProperty(LatencyStats::Operation op, const QString &device,
+                                  const QString &name, const QVariant &value,
+                                  std::function<void(const QDBusError &)> done)
+{
+    const QList<DBusPropertySync *> targets = m_auraDevices->targets(device);
+    if (targets.isEmpty()) {
+        if (done) done(QDBusError());
+        return;
+    }
+
+    // All Sets go out back to back; the batch completes with the last reply
+    struct Batch {
+        int remaining;
+        QDBusError error;
+    };
+    auto batch = std::make_shared<Batch>(Batch{static_cast<int>(targets.size()), QDBusError()});
+
+    for (DBusPropertySync *target : targets) {
+        setDBusProperty(op, target, name, value, [batch, done](const QDBusError &error) {
+            if (error.isValid() && !batch->error.isValid()) {
+                batch->error = error;
+            }
+            if (--batch->remaining == 0 && done) {
+                done(batch->error);
+            }
+        });
     }
 }
 
-void AsusdClient::fetchLedBrightness()
+QString AsusdClient::profileName(quint32 profile)
 {
-    if (m_auraPath.isEmpty()) {
-        findAuraDevice();
+    switch (profile) {
+        case 0: return "Quiet";
+        case 1: return "Balanced";
+        case 2: return "Performance";
+        default: return QString();
     }
-    if (!m_auraInterface || !m_auraInterface->isValid()) return;
+}
 
-    QDBusPendingCall call = m_auraInterface->asyncCall("Get", INTERFACE_AURA, "Brightness");
-    auto *watcher = new QDBusPendingCallWatcher(call, this);
-    connect(watcher, &QDBusPendingCallWatcher::finished,
-            this, &AsusdClient::onLedBrightnessResult);
+QString AsusdClient::fanName(quint32 fanType)
+{
+    switch (fanType) {
+        case 0: return "CPU";
+        case 1: return "GPU";
+        case 2: return "MID";
+        default: return QString();
+    }
 }
 
-void AsusdClient::onLedBrightnessResult(QDBusPendingCallWatcher *watcher)
+int AsusdClient::fanType(const QString &name)
 {
-    QDBusPendingReply<QDBusVariant> reply = *watcher;
-    if (reply.isError()) {
-        qWarning() << "Failed to get LED brightness:" << reply.error().message();
-    } else {
-        quint32 brightness = reply.value().variant().toUInt();
-        if (m_ledBrightness != brightness) {
-            m_ledBrightness = brightness;
-            emit ledBrightnessChanged(brightness);
+    for (quint32 fan = 0; fan < FAN_COUNT; fan++) {
+        if (name.compare(fanName(fan), Qt::CaseInsensitive) == 0) {
+            return static_cast<int>(fan);
         }
     }
-    watcher->deleteLater();
+    return -1;
 }
 
-void AsusdClient::setLedBrightness(quint32 level)
+AsusdCurveData AsusdClient::toAsusdCurve(const FanCurveData &curve)
 {
-    if (!m_connected || m_auraPath.isEmpty()) return;
+    AsusdCurveData data;
+    data.fan = fanName(curve.fanType);
+    data.enabled = curve.enabled;
+
+    // asusd wants exactly CURVE_POINTS points with the duty cycle as PWM (0-255)
+    data.pwm.resize(CURVE_POINTS);
+    data.temp.resize(CURVE_POINTS);
+    for (int i = 0; i < CURVE_POINTS; i++) {
+        const FanCurvePoint point = curve.points.isEmpty()
+            ? FanCurvePoint{0, 0}
+            : curve.points.at(qMin(i, int(curve.points.size()) - 1));
+        const int percent = qBound(0, int(point.fanPercent), 100);
+        data.pwm[i] = static_cast<char>((percent * 255 + 50) / 100);
+        data.temp[i] = static_cast<char>(point.temperature);
+    }
+    return data;
+}
 
-    QDBusMessage msg = QDBusMessage::createMethodCall(
-        SERVICE, m_auraPath, "org.freedesktop.DBus.Properties", "Set");
-    msg << INTERFACE_AURA << "Brightness" << QVariant::fromValue(QDBusVariant(level));
+void AsusdClient::setFanCurves(quint32 profile, const QList<FanCurveData> &curves)
+{
+    if (!m_connected || curves.isEmpty()) return;
 
-    QDBusPendingCall call = QDBusConnection::systemBus().asyncCall(msg);
-    auto *watcher = new QDBusPendingCallWatcher(call, this);
-    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, level](QDBusPendingCallWatcher *w) {
-        QDBusPendingReply<> reply = *w;
-        if (reply.isError()) {
-            qWarning() << "Failed to set LED brightness:" << reply.error().message();
-            emit errorOccurred(tr("Failed to set LED brightness: %1").arg(reply.error().message()));
+    QString profileStr = profileName(profile);
+    if (profileStr.isEmpty()) return;
+
+    QList<CallStep> calls;
+    QList<FanCurveData> changed;
+    int avoided = 0;
+
+    for (const FanCurveData &curve : curves) {
+        if (fanName(curve.fanType).isEmpty()) continue;
+
+        // Diff against the shadow copy of what the hardware holds
+        const AsusdCurveData data = toAsusdCurve(curve);
+        const bool known = m_programmedValid[profile][curve.fanType];
+        const AsusdCurveData &programmed = m_programmedCurves[profile][curve.fanType];
+        const bool samePoints = known && programmed.pwm == data.pwm && programmed.temp == data.temp;
+        const bool sameEnabled = known && programmed.enabled == data.enabled;
+
+        if (samePoints && sameEnabled) {
+            avoided++;
+            continue;
+        }
+        changed << curve;
+
+        if (!samePoints) {
+            qDebug() << "AsusdClient: Setting fan curve for" << profileStr << fanName(curve.fanType);
+
+            calls << CallStep{LatencyStats::SetFanCurve, [this, profile, data]() {
+                return m_fanCurves->SetFanCurve(profile, data);
+            }};
         } else {
-            m_ledBrightness = level;
-            emit ledBrightnessChanged(level);
+            avoided++;
+        }
+    }
+
+    if (avoided > 0) {
+        m_fanCurveWritesAvoided += avoided;
+        emit fanCurveWritesAvoidedChanged(m_fanCurveWritesAvoided);
+    }
+
+    if (changed.isEmpty()) {
+        qDebug() << "AsusdClient: Fan curves for" << profileStr << "already programmed";
+        return;
+    }
+
+    // One enable call for the whole batch unless the fans disagree
+    bool allEnabled = true;
+    bool allDisabled = true;
+    for (const FanCurveData &curve : changed) {
+        allEnabled = allEnabled && curve.enabled;
+        allDisabled = allDisabled && !curve.enabled;
+    }
+
+    if (changed.size() == curves.size() && (allEnabled || allDisabled)) {
+        calls << CallStep{LatencyStats::EnableFanCurves, [this, profile, allEnabled]() {
+            return m_fanCurves->SetFanCurvesEnabled(profile, allEnabled);
+        }};
+    } else {
+        for (const FanCurveData &curve : changed) {
+            const QString fan = fanName(curve.fanType);
+            const bool enabled = curve.enabled;
+            calls << CallStep{LatencyStats::EnableFanCurves, [this, profile, fan, enabled]() {
+                return m_fanCurves->SetProfileFanCurveEnabled(profile, fan, enabled);
+            }};
+        }
+    }
+
+    const quint64 epoch = ++m_fanCurveEpoch[profile];
+    callSequence(calls, [this, profile, changed, epoch](bool ok) {
+        // Invalidated or overtaken by another write meanwhile: which of the
+        // two the hardware holds is unknown, so resend these next time
+        const bool current = epoch == m_fanCurveEpoch[profile];
+        for (const FanCurveData &curve : changed) {
+            if (current) {
+                m_programmedCurves[profile][curve.fanType] = toAsusdCurve(curve);
+            }
+            // On failure the hardware state is unknown as well
+            m_programmedValid[profile][curve.fanType] = current && ok;
+        }
+        if (!ok) {
+            emit errorOccurred(tr("Failed to apply fan curves"));
         }
-        w->deleteLater();
     });
 }
 
-void AsusdClient::setLedMode(quint32 mode, const QColor &color1, const QColor &color2, quint8 speed)
+void AsusdClient::invalidateFanCurveCache()
 {
-    if (!m_connected || m_auraPath.isEmpty()) {
-        findAuraDevice();
-        if (m_auraPath.isEmpty()) {
-            qWarning() << "AsusdClient: Aura device not found";
-            return;
+    for (int profile = 0; profile < FAN_PROFILES; profile++) {
+        m_fanCurveEpoch[profile]++;
+        for (int fan = 0; fan < FAN_COUNT; fan++) {
+            m_programmedValid[profile][fan] = false;
         }
     }
+}
 
-    qDebug() << "AsusdClient: Setting LED mode" << mode << "color1:" << color1;
-
-    // LedModeData property has signature (uu(yyy)(yyy)ss)
-    QString speedStr = "Med";
-    if (speed == 0) speedStr = "Low";
-    else if (speed == 2) speedStr = "High";
-
-    // Use busctl-style command via QProcess for reliability - async to not block UI
-    QStringList args;
-    args << "set-property"
-         << SERVICE
-         << m_auraPath
-         << INTERFACE_AURA
-         << "LedModeData"
-         << "(uu(yyy)(yyy)ss)"
-         << QString::number(mode)
-         << "0"  // zone
-         << QString::number(color1.red())
-         << QString::number(color1.green())
-         << QString::number(color1.blue())
-         << QString::number(color2.isValid() ? color2.red() : 0)
-         << QString::number(color2.isValid() ? color2.green() : 0)
-         << QString::number(color2.isValid() ? color2.blue() : 0)
-         << speedStr
-         << "Right";
-
-    QProcess *process = new QProcess(this);
-    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [this, process](int exitCode, QProcess::ExitStatus) {
-        if (exitCode != 0) {
-            qWarning() << "Failed to set LED mode:" << process->readAllStandardError();
-            emit errorOccurred(tr("Failed to set LED mode"));
+void AsusdClient::readFanCurves(quint32 profile, std::function<void()> done)
+{
+    if (!m_connected || profile >= FAN_PROFILES) return;
+    // One read per profile at a time; a refresh during a read adds nothing
+    if (m_fanCurveReading[profile] && !done) return;
+    m_fanCurveReading[profile] = true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const quint64 epoch = m_fanCurveEpoch[profile];
+    QDBusPendingCall call = m_fanCurves->FanCurveData(profile);
+    auto *watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished,
+            this, [this, profile, epoch, timer, done](QDBusPendingCallWatcher *w) {
+        QDBusPendingReply<QList<AsusdCurveData>> reply = *w;
+        LatencyStats::instance()->record(LatencyStats::ReadFanCurves, timer.nsecsElapsed(), reply.isError());
+        m_fanCurveReading[profile] = false;
+        w->deleteLater();
+
+        if (reply.isError()) {
+            // Older asusd or no curve support on this machine: keep writing
+            qDebug() << "AsusdClient: FanCurveData failed:" << reply.error().message();
+        } else if (epoch != m_fanCurveEpoch[profile]) {
+            // A write went out meanwhile; what we read may already be stale
+            qDebug() << "AsusdClient: Discarding fan curves read during a write";
         } else {
-            qDebug() << "AsusdClient: LED mode set successfully";
+            const QList<AsusdCurveData> curves = reply.value();
+            for (const AsusdCurveData &curve : curves) {
+                const int fan = fanType(curve.fan);
+                if (fan < 0 || fan >= FAN_COUNT) continue;
+                m_programmedCurves[profile][fan] = curve;
+                m_programmedValid[profile][fan] = true;
+            }
         }
-        process->deleteLater();
+        if (done) done();
     });
-
-    process->start("busctl", args);
 }
 
-QVariantList AsusdClient::getFanCurves(quint32 profile)
+void AsusdClient::setDBusProperty(LatencyStats::Operation op, DBusPropertySync *target,
+                                  const QString &name, const QVariant &value,
+                                  std::function<void(const QDBusError &)> done)
 {
-    QVariantList result;
-    // Fan curve retrieval would be implemented based on actual asusd fan curve API
-    // For now, return default curves
-
-    // CPU fan default curve
-    QVariantMap cpuCurve;
-    cpuCurve["fanType"] = 0;
-    cpuCurve["enabled"] = true;
-    QVariantList cpuPoints;
-    cpuPoints << QVariantMap{{"temp", 30}, {"fan", 0}};
-    cpuPoints << QVariantMap{{"temp", 40}, {"fan", 20}};
-    cpuPoints << QVariantMap{{"temp", 50}, {"fan", 35}};
-    cpuPoints << QVariantMap{{"temp", 60}, {"fan", 50}};
-    cpuPoints << QVariantMap{{"temp", 70}, {"fan", 70}};
-    cpuPoints << QVariantMap{{"temp", 80}, {"fan", 85}};
-    cpuPoints << QVariantMap{{"temp", 90}, {"fan", 95}};
-    cpuPoints << QVariantMap{{"temp", 100}, {"fan", 100}};
-    cpuCurve["points"] = cpuPoints;
-    result << cpuCurve;
-
-    // GPU fan default curve
-    QVariantMap gpuCurve;
-    gpuCurve["fanType"] = 1;
-    gpuCurve["enabled"] = true;
-    gpuCurve["points"] = cpuPoints; // Same as CPU for default
-    result << gpuCurve;
-
-    return result;
+    QElapsedTimer timer;
+    timer.start();
+
+    QDBusPendingCall call = target->set(name, value);
+    auto *watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished,
+            this, [op, timer, done](QDBusPendingCallWatcher *w) {
+        QDBusPendingReply<> reply = *w;
+        LatencyStats::instance()->record(op, timer.nsecsElapsed(), reply.isError());
+        if (done) done(reply.isError() ? reply.error() : QDBusError());
+        w->deleteLater();
+    });
 }
 
-void AsusdClient::setFanCurve(quint32 profile, quint32 fanType, const QVariantList &points, bool enabled)
+void AsusdClient::callSequence(QList<CallStep> calls, std::function<void(bool)> done)
 {
-    if (!m_connected) return;
-
-    // Convert profile to name
-    QString profileName;
-    switch (profile) {
-        case 0: profileName = "Quiet"; break;
-        case 1: profileName = "Balanced"; break;
-        case 2: profileName = "Performance"; break;
-        default: return;
+    if (calls.isEmpty()) {
+        if (done) done(true);
+        return;
     }
 
-    // Convert fan type to name
-    QString fanName = (fanType == 0) ? "cpu" : "gpu";
+    // asusd applies fan curves one by one; send them in order, asynchronously
+    const CallStep step = calls.takeFirst();
 
-    // Build curve data string: "30c:0%,40c:15%,..."
-    QStringList dataPoints;
-    for (const QVariant &point : points) {
-        QVariantMap p = point.toMap();
-        int temp = p["temp"].toInt();
-        int fan = p["fan"].toInt();
-        dataPoints << QString("%1c:%2%").arg(temp).arg(fan);
-    }
-    QString curveData = dataPoints.join(",");
-
-    qDebug() << "AsusdClient: Setting fan curve for" << profileName << fanName << ":" << curveData;
+    QElapsedTimer timer;
+    timer.start();
 
-    // Run asynchronously to not block UI
-    QProcess *process = new QProcess(this);
-    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [this, process, profileName, fanName, enabled](int exitCode, QProcess::ExitStatus) {
-        if (exitCode != 0) {
-            QString error = QString::fromUtf8(process->readAllStandardError());
-            qWarning() << "Failed to set fan curve:" << error;
+    QDBusPendingCall call = step.send();
+    auto *watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished,
+            this, [this, op = step.op, timer, calls, done](QDBusPendingCallWatcher *w) {
+        QDBusPendingReply<> reply = *w;
+        LatencyStats::instance()->record(op, timer.nsecsElapsed(), reply.isError());
+        if (reply.isError()) {
+            qWarning() << "AsusdClient:" << LatencyStats::operationName(op)
+                       << "failed:" << reply.error().message();
+            if (done) done(false);
         } else {
-            qDebug() << "AsusdClient: Fan curve set successfully";
-
-            // Enable the fan curve asynchronously
-            QProcess *enableProcess = new QProcess(this);
-            connect(enableProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-                    enableProcess, &QProcess::deleteLater);
-
-            QStringList enableArgs;
-            enableArgs << "fan-curve" << "--mod-profile" << profileName
-                       << "--enable-fan-curves" << (enabled ? "true" : "false");
-            enableProcess->start("asusctl", enableArgs);
+            callSequence(calls, done);
         }
-        process->deleteLater();
+        w->deleteLater();
     });
-
-    QStringList args;
-    args << "fan-curve" << "--mod-profile" << profileName << "--fan" << fanName << "--data" << curveData;
-    process->start("asusctl", args);
 }
 
 void AsusdClient::resetFanCurves(quint32 profile)
 {
     if (!m_connected) return;
 
-    qDebug() << "Resetting fan curves for profile" << profile;
-    emit fanCurvesChanged();
+    if (profileName(profile).isEmpty()) return;
+
+    qDebug() << "AsusdClient: Resetting fan curves for" << profileName(profile);
+    m_fanCurveEpoch[profile]++;
+    for (int fan = 0; fan < FAN_COUNT; fan++) {
+        m_programmedValid[profile][fan] = false;
+    }
+
+    callSequence({CallStep{LatencyStats::ResetFanCurves, [this, profile]() {
+        return m_fanCurves->ResetProfileCurves(profile);
+    }}}, [this, profile](bool ok) {
+        if (!ok) {
+            emit errorOccurred(tr("Failed to reset fan curves"));
+        }
+        // The defaults asusd restored become the new shadow copy
+        readFanCurves(profile, [this]() {
+            emit fanCurvesChanged();
+        });
+    });
 }
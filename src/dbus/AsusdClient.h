@@ -3,11 +3,16 @@
 
 #include <QObject>
 #include <QDBusConnection>
-#include <QDBusInterface>
 #include <QDBusPendingCallWatcher>
-#include <QColor>
-#include <QElapsedTimer>
+#include <QStringList>
+#include <functional>
 #include "DBusTypes.h"
+#include "PendingWriteTracker.h"
+#include "LatencyStats.h"
+
+class DBusPropertySync;
+class AuraDeviceRegistry;
+class FanCurvesProxy;
 
 class AsusdClient : public QObject
 {
@@ -16,6 +21,8 @@ class AsusdClient : public QObject
     Q_PROPERTY(quint32 platformProfile READ platformProfile NOTIFY platformProfileChanged)
     Q_PROPERTY(quint8 chargeLimit READ chargeLimit NOTIFY chargeLimitChanged)
     Q_PROPERTY(quint32 ledBrightness READ ledBrightness NOTIFY ledBrightnessChanged)
+    Q_PROPERTY(QStringList auraDevices READ auraDevices NOTIFY auraDevicesChanged)
+    Q_PROPERTY(int fanCurveWritesAvoided READ fanCurveWritesAvoided NOTIFY fanCurveWritesAvoidedChanged)
 
 public:
     explicit AsusdClient(QObject *parent = nullptr);
@@ -31,56 +38,109 @@ public:
     quint8 chargeLimit() const { return m_chargeLimit; }
     Q_INVOKABLE void setChargeLimit(quint8 limit);
 
-    // LED/Aura
+    // LED/Aura. An empty device targets every Aura device in one batch;
+    // ledBrightness reflects the first (primary) device
     quint32 ledBrightness() const { return m_ledBrightness; }
-    Q_INVOKABLE void setLedBrightness(quint32 level);
-    Q_INVOKABLE void setLedMode(quint32 mode, const QColor &color1, const QColor &color2 = QColor(), quint8 speed = 1);
+    QStringList auraDevices() const;
+    Q_INVOKABLE void setLedBrightness(quint32 level, const QString &device = QString());
+    void setLedMode(quint32 mode, const AuraColor &color1, const AuraColor &color2 = {0, 0, 0},
+                    quint8 speed = 1, const QString &device = QString());
 
     // Fan curves
-    Q_INVOKABLE QVariantList getFanCurves(quint32 profile);
-    Q_INVOKABLE void setFanCurve(quint32 profile, quint32 fanType, const QVariantList &points, bool enabled);
+    // Applies all given curves of one profile as a single batch. Only the
+    // curves that differ from what the hardware is known to hold are sent.
+    void setFanCurves(quint32 profile, const QList<FanCurveData> &curves);
+    // Forget what we believe is programmed (e.g. after asusd restarted)
+    Q_INVOKABLE void invalidateFanCurveCache();
+    // Re-reads what asusd holds for the profile into the shadow copy
+    void readFanCurves(quint32 profile, std::function<void()> done = {});
+    int fanCurveWritesAvoided() const { return m_fanCurveWritesAvoided; }
     Q_INVOKABLE void resetFanCurves(quint32 profile);
 
     Q_INVOKABLE void refresh();
+    // Probes for asusd again if it was not there before
+    Q_INVOKABLE void reconnect();
+    // asusd left the bus: forget its state until reconnect() finds it again
+    void serviceLost();
 
 signals:
     void connectedChanged(bool connected);
     void platformProfileChanged(quint32 profile);
     void chargeLimitChanged(quint8 limit);
     void ledBrightnessChanged(quint32 brightness);
+    void auraDevicesChanged();
     void fanCurvesChanged();
+    void fanCurveWritesAvoidedChanged(int count);
     void errorOccurred(const QString &error);
 
 private slots:
-    void onPlatformProfileResult(QDBusPendingCallWatcher *watcher);
-    void onChargeLimitResult(QDBusPendingCallWatcher *watcher);
-    void onLedBrightnessResult(QDBusPendingCallWatcher *watcher);
-    void onPropertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated);
+    void onPlatformPropertiesUpdated(const QVariantMap &changed);
+    void onAuraPropertiesUpdated(const QVariantMap &changed);
 
 private:
     void setupConnections();
-    void fetchPlatformProfile();
-    void fetchChargeLimit();
-    void fetchLedBrightness();
-    void findAuraDevice();
+    void onServiceAvailable();
+    void onAuraDeviceAdded(const QString &node, DBusPropertySync *device);
+    void onAuraScanFinished(bool found);
+    void sendLedMode(const AuraEffect &effect, const QString &device);
+    // Properties.Set on each target Aura device at once; done runs once with the first error
+    void setAuraProperty(LatencyStats::Operation op, const QString &device,
+                         const QString &name, const QVariant &value,
+                         std::function<void(const QDBusError &)> done = {});
+    void writeFailed(DBusPropertySync *sync, const QString &name, quint64 generation);
+    // Properties.Set on the shared system bus connection; done gets an invalid error on success
+    void setDBusProperty(LatencyStats::Operation op, DBusPropertySync *target,
+                         const QString &name, const QVariant &value,
+                         std::function<void(const QDBusError &)> done = {});
+
+    // One typed proxy call, issued only when its turn comes
+    struct CallStep {
+        LatencyStats::Operation op;
+        std::function<QDBusPendingCall()> send;
+    };
+    // Sends the calls one after another, stopping at the first error
+    void callSequence(QList<CallStep> calls, std::function<void(bool)> done = {});
+
+    static QString profileName(quint32 profile);
+    static QString fanName(quint32 fanType);
+    static int fanType(const QString &name);
+    static AsusdCurveData toAsusdCurve(const FanCurveData &curve);
 
     static constexpr const char* SERVICE = "xyz.ljones.Asusd";
     static constexpr const char* PATH_PLATFORM = "/xyz/ljones";
     static constexpr const char* INTERFACE_PLATFORM = "xyz.ljones.Platform";
-    static constexpr const char* INTERFACE_AURA = "xyz.ljones.Aura";
+    static constexpr int CURVE_POINTS = 8;
+
+    // Aura devices, discovered asynchronously once and kept current
+    AuraDeviceRegistry *m_auraDevices = nullptr;
+    AuraEffect m_queuedLedMode;
+    QString m_queuedLedDevice;
+    bool m_hasQueuedLedMode = false;
+
+    // Typed proxy generated from interfaces/xyz.ljones.FanCurves.xml
+    FanCurvesProxy *m_fanCurves = nullptr;
 
-    QDBusInterface *m_platformInterface = nullptr;
-    QDBusInterface *m_auraInterface = nullptr;
-    QString m_auraPath;
+    // Property caches, one GetAll per interface per refresh
+    DBusPropertySync *m_platformSync = nullptr;
 
     bool m_connected = false;
     quint32 m_platformProfile = 1; // Balanced
     quint8 m_chargeLimit = 100;
     quint32 m_ledBrightness = 2; // Medium
 
-    // Ignore D-Bus profile updates briefly after we set it ourselves
-    QElapsedTimer m_profileSetTimer;
-    bool m_ignoringProfileUpdates = false;
+    // Shadow copy of the curves known to be programmed, per profile and fan,
+    // as sent on the wire. Seeded from FanCurveData reads and our own writes.
+    static constexpr int FAN_PROFILES = 3;
+    static constexpr int FAN_COUNT = 3;
+    AsusdCurveData m_programmedCurves[FAN_PROFILES][FAN_COUNT];
+    bool m_programmedValid[FAN_PROFILES][FAN_COUNT] = {};
+    // Bumped by every write, so a read that raced one is not trusted
+    quint64 m_fanCurveEpoch[FAN_PROFILES] = {};
+    bool m_fanCurveReading[FAN_PROFILES] = {};
+    int m_fanCurveWritesAvoided = 0;
+
+    // Local writes not yet confirmed by asusd, keyed by property name
+    PendingWriteTracker m_pendingWrites;
 };
 
 #endif // ASUSDCLIENT_H
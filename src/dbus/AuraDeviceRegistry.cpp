@@ -0,0 +1,172 @@
+#include "AuraDeviceRegistry.h"
+#include "DBusPropertySync.h"
+#include "SystemBus.h"
+#include "LatencyStats.h"
+#include <QDBusArgument>
+#include <QDBusMessage>
+#include <QDBusObjectPath>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDebug>
+#include <QRegularExpression>
+#include <QSet>
+
+AuraDeviceRegistry::AuraDeviceRegistry(const QString &service, QObject *parent)
+    : QObject(parent)
+    , m_service(service)
+{
+    // Empty path: asusd's ObjectManager may live on any ancestor of the aura nodes
+    QDBusConnection bus = SystemBus::connection();
+    bus.connect(m_service, QString(), "org.freedesktop.DBus.ObjectManager", "InterfacesAdded",
+                this, SLOT(onInterfacesAdded(QDBusMessage)));
+    bus.connect(m_service, QString(), "org.freedesktop.DBus.ObjectManager", "InterfacesRemoved",
+                this, SLOT(onInterfacesRemoved(QDBusMessage)));
+}
+
+AuraDeviceRegistry::~AuraDeviceRegistry() = default;
+
+bool AuraDeviceRegistry::isKnownAbsent() const
+{
+    return m_absentSince.isValid() && m_absentSince.elapsed() < NEGATIVE_CACHE_MS;
+}
+
+DBusPropertySync *AuraDeviceRegistry::primary() const
+{
+    return m_devices.isEmpty() ? nullptr : m_devices.first();
+}
+
+QList<DBusPropertySync *> AuraDeviceRegistry::targets(const QString &node) const
+{
+    if (node.isEmpty()) {
+        return m_devices.values();
+    }
+    DBusPropertySync *sync = m_devices.value(node);
+    return sync ? QList<DBusPropertySync *>{sync} : QList<DBusPropertySync *>{};
+}
+
+void AuraDeviceRegistry::discover(bool force)
+{
+    if (m_scanInFlight) return;
+    if (!force && (m_scanned && !m_devices.isEmpty())) return;
+    if (!force && isKnownAbsent()) return;
+
+    m_scanInFlight = true;
+
+    QDBusMessage msg = QDBusMessage::createMethodCall(
+        m_service, AURA_ROOT, "org.freedesktop.DBus.Introspectable", "Introspect");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QDBusPendingCall call = SystemBus::connection().asyncCall(msg);
+    auto *watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, timer](QDBusPendingCallWatcher *w) {
+        m_scanInFlight = false;
+        m_scanned = true;
+
+        QDBusPendingReply<QString> reply = *w;
+        LatencyStats::instance()->record(LatencyStats::IntrospectAura, timer.nsecsElapsed(), reply.isError());
+        w->deleteLater();
+
+        // An error here usually means the aura root doesn't exist at all,
+        // which is as much an answer as an empty node list
+        QSet<QString> found;
+        if (reply.isError()) {
+            qWarning() << "AuraDeviceRegistry: Failed to introspect aura devices:" << reply.error().message();
+        } else {
+            // Child nodes like "19b6_3_4", one per device
+            static const QRegularExpression re("<node name=\"([^\"]+)\"");
+            auto it = re.globalMatch(reply.value());
+            while (it.hasNext()) {
+                found.insert(it.next().captured(1));
+            }
+        }
+
+        for (const QString &node : devices()) {
+            if (!found.contains(node)) removeDevice(node);
+        }
+        for (const QString &node : std::as_const(found)) {
+            addDevice(node);
+        }
+
+        if (m_devices.isEmpty()) {
+            qWarning() << "AuraDeviceRegistry: No Aura device found";
+            m_absentSince.start();
+        } else {
+            qDebug() << "AuraDeviceRegistry: Aura devices:" << devices();
+            m_absentSince.invalidate();
+        }
+        emit scanFinished(!m_devices.isEmpty());
+    });
+}
+
+void AuraDeviceRegistry::clear()
+{
+    for (const QString &node : devices()) {
+        removeDevice(node);
+    }
+    m_scanned = false;
+    m_absentSince.invalidate();
+}
+
+void AuraDeviceRegistry::onInterfacesAdded(const QDBusMessage &message)
+{
+    if (message.arguments().size() < 2) return;
+
+    const QString node = nodeFromPath(message.arguments().at(0).value<QDBusObjectPath>().path());
+    if (node.isEmpty()) return;
+
+    const auto interfaces = qdbus_cast<QMap<QString, QVariantMap>>(message.arguments().at(1));
+    if (!interfaces.contains(INTERFACE_AURA)) return;
+
+    // Hotplugged (or asusd restarted): the negative answer no longer holds
+    m_absentSince.invalidate();
+    addDevice(node);
+}
+
+void AuraDeviceRegistry::onInterfacesRemoved(const QDBusMessage &message)
+{
+    if (message.arguments().size() < 2) return;
+
+    const QString node = nodeFromPath(message.arguments().at(0).value<QDBusObjectPath>().path());
+    if (node.isEmpty()) return;
+
+    const QStringList interfaces = message.arguments().at(1).toStringList();
+    if (interfaces.contains(INTERFACE_AURA)) {
+        removeDevice(node);
+    }
+}
+
+void AuraDeviceRegistry::addDevice(const QString &node)
+{
+    if (m_devices.contains(node)) return;
+
+    auto *sync = new DBusPropertySync(m_service, QString(AURA_ROOT) + '/' + node, INTERFACE_AURA, this);
+    m_devices.insert(node, sync);
+    sync->refresh();
+
+    qDebug() << "AuraDeviceRegistry: Added" << node;
+    emit deviceAdded(node, sync);
+    emit devicesChanged();
+}
+
+void AuraDeviceRegistry::removeDevice(const QString &node)
+{
+    DBusPropertySync *sync = m_devices.take(node);
+    if (!sync) return;
+
+    qDebug() << "AuraDeviceRegistry: Removed" << node;
+    emit deviceRemoved(node);
+    emit devicesChanged();
+    sync->deleteLater();
+}
+
+QString AuraDeviceRegistry::nodeFromPath(const QString &path)
+{
+    // Only direct children of the aura root are devices
+    const QString prefix = QString(AURA_ROOT) + '/';
+    if (!path.startsWith(prefix)) return QString();
+
+    const QString node = path.mid(prefix.size());
+    return node.contains('/') ? QString() : node;
+}
@@ -0,0 +1,75 @@
+#ifndef AURADEVICEREGISTRY_H
+#define AURADEVICEREGISTRY_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QStringList>
+
+class QDBusMessage;
+class DBusPropertySync;
+
+// Every Aura device asusd exposes below /xyz/ljones/aura (keyboard, lightbar,
+// logo, ... each as its own node, e.g. /xyz/ljones/aura/19b6_3_4).
+//
+// The node list comes from one asynchronous Introspect and is then kept
+// current through ObjectManager.InterfacesAdded/InterfacesRemoved. A scan
+// that finds nothing is remembered for NEGATIVE_CACHE_MS so machines
+// without Aura hardware don't pay a round trip on every LED interaction.
+class AuraDeviceRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AuraDeviceRegistry(const QString &service, QObject *parent = nullptr);
+    ~AuraDeviceRegistry() override;
+
+    // Starts a scan unless one is in flight, one already succeeded, or a
+    // recent one found nothing; force ignores the last two
+    void discover(bool force = false);
+    // Drops all devices, e.g. when the daemon went away
+    void clear();
+
+    bool isScanned() const { return m_scanned; }
+    bool isScanning() const { return m_scanInFlight; }
+    // A recent scan found no Aura device
+    bool isKnownAbsent() const;
+
+    // Node names, sorted so the first one is stable across scans
+    QStringList devices() const { return m_devices.keys(); }
+    DBusPropertySync *device(const QString &node) const { return m_devices.value(node); }
+    // The device whose state the UI reflects
+    DBusPropertySync *primary() const;
+    // One device, or every device when node is empty
+    QList<DBusPropertySync *> targets(const QString &node = QString()) const;
+
+    static constexpr const char* AURA_ROOT = "/xyz/ljones/aura";
+    static constexpr const char* INTERFACE_AURA = "xyz.ljones.Aura";
+
+signals:
+    void deviceAdded(const QString &node, DBusPropertySync *device);
+    void deviceRemoved(const QString &node);
+    void devicesChanged();
+    // A scan completed (found is false when no device exists)
+    void scanFinished(bool found);
+
+private slots:
+    void onInterfacesAdded(const QDBusMessage &message);
+    void onInterfacesRemoved(const QDBusMessage &message);
+
+private:
+    void addDevice(const QString &node);
+    void removeDevice(const QString &node);
+    static QString nodeFromPath(const QString &path);
+
+    static constexpr qint64 NEGATIVE_CACHE_MS = 60000;
+
+    QString m_service;
+    QMap<QString, DBusPropertySync *> m_devices;
+
+    bool m_scanned = false;
+    bool m_scanInFlight = false;
+    QElapsedTimer m_absentSince; // Valid while the last scan found nothing
+};
+
+#endif // AURADEVICEREGISTRY_H
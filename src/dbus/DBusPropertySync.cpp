@@ -0,0 +1,118 @@
+#include "DBusPropertySync.h"
+#include "SystemBus.h"
+#include "LatencyStats.h"
+#include "propertiesproxy.h"
+#include <QDBusArgument>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDebug>
+#include <QTimer>
+
+DBusPropertySync::DBusPropertySync(const QString &service, const QString &path,
+                                   const QString &interface, QObject *parent)
+    : QObject(parent)
+    , m_proxy(new PropertiesProxy(service, path, SystemBus::connection(), this))
+    , m_path(path)
+    , m_interface(interface)
+{
+    connect(m_proxy, &PropertiesProxy::PropertiesChanged,
+            this, &DBusPropertySync::onPropertiesChanged);
+}
+
+DBusPropertySync::~DBusPropertySync() = default;
+
+void DBusPropertySync::refresh()
+{
+    if (m_scheduled || m_inFlight) return;
+
+    // Let every caller in this event loop turn piggyback on one GetAll
+    m_scheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        m_scheduled = false;
+        fetch();
+    });
+}
+
+void DBusPropertySync::fetch()
+{
+    if (m_inFlight) return;
+
+    m_inFlight = true;
+    m_fetchCount++;
+    m_fetchTimer.start();
+
+    QDBusPendingCall call = m_proxy->GetAll(m_interface);
+    auto *watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished,
+            this, &DBusPropertySync::onGetAllFinished);
+}
+
+void DBusPropertySync::onGetAllFinished(QDBusPendingCallWatcher *watcher)
+{
+    m_inFlight = false;
+
+    QDBusPendingReply<QVariantMap> reply = *watcher;
+    LatencyStats::instance()->record(LatencyStats::PropertiesGetAll,
+                                     m_fetchTimer.nsecsElapsed(), reply.isError());
+    if (reply.isError()) {
+        qWarning() << "DBusPropertySync: GetAll" << m_interface << "failed:" << reply.error().message();
+        emit fetchFailed(reply.error().message());
+    } else {
+        m_populated = true;
+        merge(reply.value());
+    }
+    watcher->deleteLater();
+
+    if (m_refetch) {
+        m_refetch = false;
+        refresh();
+    }
+}
+
+QDBusPendingCall DBusPropertySync::set(const QString &name, const QVariant &value)
+{
+    return m_proxy->Set(m_interface, name, QDBusVariant(value));
+}
+
+void DBusPropertySync::onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                                           const QStringList &invalidated)
+{
+    if (interface != m_interface) return;
+
+    merge(changed);
+
+    if (!invalidated.isEmpty()) {
+        // Values we can no longer trust; fetch them again in one go
+        for (const QString &name : invalidated) {
+            m_cache.remove(name);
+        }
+        if (m_inFlight) {
+            m_refetch = true;
+        } else {
+            refresh();
+        }
+    }
+}
+
+void DBusPropertySync::merge(const QVariantMap &values)
+{
+    QVariantMap updated;
+    for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+        // Structured values arrive as QDBusArgument, which has no equality
+        const QVariant &value = it.value();
+        if (value.userType() == qMetaTypeId<QDBusArgument>()) {
+            updated.insert(it.key(), value);
+            m_cache.insert(it.key(), value);
+            continue;
+        }
+        auto cached = m_cache.constFind(it.key());
+        if (cached == m_cache.constEnd() || cached.value() != value) {
+            updated.insert(it.key(), value);
+            m_cache.insert(it.key(), value);
+        }
+    }
+
+    if (!updated.isEmpty()) {
+        emit propertiesUpdated(updated);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef DBUSPROPERTYSYNC_H
+#define DBUSPROPERTYSYNC_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVariantMap>
+
+class QDBusPendingCall;
+class QDBusPendingCallWatcher;
+class PropertiesProxy;
+
+// Authoritative cache of one D-Bus object's properties on one interface.
+//
+// The cache is filled with a single Properties.GetAll and kept current by
+// PropertiesChanged. refresh() is coalesced: any number of calls within one
+// event loop turn, or while a GetAll is already in flight, cost one round
+// trip.
+class DBusPropertySync : public QObject
+{
+    Q_OBJECT
+
+public:
+    DBusPropertySync(const QString &service, const QString &path,
+                     const QString &interface, QObject *parent = nullptr);
+    ~DBusPropertySync() override;
+
+    QString path() const { return m_path; }
+    QString interface() const { return m_interface; }
+
+    bool isPopulated() const { return m_populated; }
+    QVariant value(const QString &name) const { return m_cache.value(name); }
+    const QVariantMap &values() const { return m_cache; }
+
+    // Schedules a GetAll unless one is already scheduled or in flight
+    void refresh();
+
+    // Properties.Set for one property of this interface
+    QDBusPendingCall set(const QString &name, const QVariant &value);
+
+    // Number of GetAll round trips actually made
+    int fetchCount() const { return m_fetchCount; }
+
+signals:
+    // Only the properties whose value differs from the cache
+    void propertiesUpdated(const QVariantMap &changed);
+    void fetchFailed(const QString &error);
+
+private slots:
+    void onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                             const QStringList &invalidated);
+
+private:
+    void fetch();
+    void onGetAllFinished(QDBusPendingCallWatcher *watcher);
+    void merge(const QVariantMap &values);
+
+    PropertiesProxy *m_proxy;
+    QString m_path;
+    QString m_interface;
+    QVariantMap m_cache;
+
+    bool m_populated = false;
+    bool m_scheduled = false;
+    bool m_inFlight = false;
+    bool m_refetch = false; // Invalidated while a GetAll was in flight
+    int m_fetchCount = 0;
+    QElapsedTimer m_fetchTimer;
+};
+
+#endif // DBUSPROPERTYSYNC_H
@@ -3,6 +3,8 @@
 
 #include <QDBusArgument>
 #include <QDBusMetaType>
+#include <QByteArray>
+#include <QString>
 #include <QVector>
 #include <QPair>
 
@@ -29,10 +31,15 @@ struct FanCurvePoint {
     quint8 fanPercent;
 };
 
+inline bool operator==(const FanCurvePoint &a, const FanCurvePoint &b)
+{
+    return a.temperature == b.temperature && a.fanPercent == b.fanPercent;
+}
+
 // Fan curve data
 struct FanCurveData {
     quint32 profile;
-    quint32 fanType; // 0 = CPU, 1 = GPU
+    quint32 fanType; // 0 = CPU, 1 = GPU, 2 = Mid
     bool enabled;
     QVector<FanCurvePoint> points;
 };
@@ -60,13 +67,22 @@ struct AuraColor {
     quint8 blue;
 };
 
-// Aura effect settings
+// Aura effect settings, laid out as asusd's LedModeData: (uu(yyy)(yyy)ss)
 struct AuraEffect {
-    AuraMode mode;
+    quint32 mode;       // AuraMode
+    quint32 zone;       // 0 = all zones
     AuraColor color1;
     AuraColor color2;
-    quint8 speed;
-    quint8 direction;
+    QString speed;      // "Low", "Med", "High"
+    QString direction;  // "Right", "Left", "Up", "Down"
+};
+
+// One fan curve as asusd's FanCurves interface expects it: (sayayb)
+struct AsusdCurveData {
+    QString fan;        // "CPU", "GPU", "MID"
+    QByteArray pwm;     // 8 points, 0-255
+    QByteArray temp;    // 8 points, degrees C
+    bool enabled;
 };
 
 // D-Bus argument operators for FanCurvePoint
@@ -103,6 +119,42 @@ inline const QDBusArgument &operator>>(const QDBusArgument &arg, AuraColor &colo
     return arg;
 }
 
+// D-Bus argument operators for AuraEffect
+inline QDBusArgument &operator<<(QDBusArgument &arg, const AuraEffect &effect)
+{
+    arg.beginStructure();
+    arg << effect.mode << effect.zone << effect.color1 << effect.color2
+        << effect.speed << effect.direction;
+    arg.endStructure();
+    return arg;
+}
+
+inline const QDBusArgument &operator>>(const QDBusArgument &arg, AuraEffect &effect)
+{
+    arg.beginStructure();
+    arg >> effect.mode >> effect.zone >> effect.color1 >> effect.color2
+        >> effect.speed >> effect.direction;
+    arg.endStructure();
+    return arg;
+}
+
+// D-Bus argument operators for AsusdCurveData
+inline QDBusArgument &operator<<(QDBusArgument &arg, const AsusdCurveData &curve)
+{
+    arg.beginStructure();
+    arg << curve.fan << curve.pwm << curve.temp << curve.enabled;
+    arg.endStructure();
+    return arg;
+}
+
+inline const QDBusArgument &operator>>(const QDBusArgument &arg, AsusdCurveData &curve)
+{
+    arg.beginStructure();
+    arg >> curve.fan >> curve.pwm >> curve.temp >> curve.enabled;
+    arg.endStructure();
+    return arg;
+}
+
 // Register metatypes
 inline void registerDBusTypes()
 {
@@ -110,8 +162,12 @@ inline void registerDBusTypes()
     qRegisterMetaType<FanCurveData>("FanCurveData");
     qRegisterMetaType<AuraColor>("AuraColor");
     qRegisterMetaType<AuraEffect>("AuraEffect");
+    qRegisterMetaType<AsusdCurveData>("AsusdCurveData");
     qDBusRegisterMetaType<FanCurvePoint>();
     qDBusRegisterMetaType<AuraColor>();
+    qDBusRegisterMetaType<AuraEffect>();
+    qDBusRegisterMetaType<AsusdCurveData>();
+    qDBusRegisterMetaType<QList<AsusdCurveData>>();
     qDBusRegisterMetaType<QVector<FanCurvePoint>>();
 }
 
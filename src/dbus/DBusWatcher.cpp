@@ -1,13 +1,20 @@
 #include "DBusWatcher.h"
-#include <QDBusConnectionInterface>
+#include "SystemBus.h"
+#include "Trace.h"
 #include <QDebug>
+#include <QStandardPaths>
 
 DBusWatcher::DBusWatcher(QObject *parent)
     : QObject(parent)
     , m_watcher(new QDBusServiceWatcher(this))
-    , m_retryTimer(new QTimer(this))
 {
-    m_watcher->setConnection(QDBusConnection::systemBus());
+    TRACE_SPAN("DBusWatcher", "dbus");
+    // Remember which daemons are not installed at all (common: no supergfxd
+    // on AMD-only machines) so nothing waits on them
+    m_asusdInstalled = isInstalled("asusd");
+    m_supergfxInstalled = isInstalled("supergfxd");
+
+    m_watcher->setConnection(SystemBus::connection());
     m_watcher->addWatchedService(ASUSD_SERVICE);
     m_watcher->addWatchedService(SUPERGFX_SERVICE);
 
@@ -16,53 +23,62 @@ DBusWatcher::DBusWatcher(QObject *parent)
     connect(m_watcher, &QDBusServiceWatcher::serviceUnregistered,
             this, &DBusWatcher::onServiceUnregistered);
 
-    m_retryTimer->setInterval(5000); // Retry every 5 seconds
-    connect(m_retryTimer, &QTimer::timeout, this, &DBusWatcher::onRetryConnection);
-
-    // Initial check
+    // Initial check; after that NameOwnerChanged keeps us current
     checkConnections();
 }
 
 DBusWatcher::~DBusWatcher() = default;
 
+bool DBusWatcher::allConnected() const
+{
+    return (m_asusdConnected || !m_asusdInstalled)
+        && (m_supergfxConnected || !m_supergfxInstalled);
+}
+
 QString DBusWatcher::connectionStatus() const
 {
-    if (m_asusdConnected && m_supergfxConnected) {
+    if (allConnected()) {
         return tr("Connected");
     }
 
     QStringList missing;
-    if (!m_asusdConnected) missing << "asusd";
-    if (!m_supergfxConnected) missing << "supergfxd";
+    if (!m_asusdConnected && m_asusdInstalled) missing << "asusd";
+    if (!m_supergfxConnected && m_supergfxInstalled) missing << "supergfxd";
 
     return tr("Disconnected: %1").arg(missing.join(", "));
 }
 
+bool DBusWatcher::isInstalled(const QString &executable)
+{
+    // Stand-in daemons on an overridden bus have no binaries to find
+    if (!SystemBus::overrideAddress().isEmpty()) return true;
+
+    if (!QStandardPaths::findExecutable(executable).isEmpty()) return true;
+    const QStringList systemPaths{"/usr/bin", "/usr/sbin", "/usr/local/bin", "/usr/libexec"};
+    return !QStandardPaths::findExecutable(executable, systemPaths).isEmpty();
+}
+
 void DBusWatcher::checkConnections()
 {
     checkAsusd();
     checkSupergfx();
-
-    // Start retry timer if not all connected
-    if (!allConnected() && !m_retryTimer->isActive()) {
-        m_retryTimer->start();
-    } else if (allConnected() && m_retryTimer->isActive()) {
-        m_retryTimer->stop();
-    }
 }
 
 void DBusWatcher::checkAsusd()
 {
-    QDBusConnection bus = QDBusConnection::systemBus();
-    bool connected = bus.interface()->isServiceRegistered(ASUSD_SERVICE);
-    setAsusdConnected(connected);
+    SystemBus::probeService(ASUSD_SERVICE, this, [this](bool connected) {
+        setAsusdConnected(connected);
+    });
 }
 
 void DBusWatcher::checkSupergfx()
 {
-    QDBusConnection bus = QDBusConnection::systemBus();
-    bool connected = bus.interface()->isServiceRegistered(SUPERGFX_SERVICE);
-    setSupergfxConnected(connected);
+    if (!m_supergfxInstalled) {
+        qDebug() << "supergfxd does not appear to be installed";
+    }
+    SystemBus::probeService(SUPERGFX_SERVICE, this, [this](bool connected) {
+        setSupergfxConnected(connected);
+    });
 }
 
 void DBusWatcher::setAsusdConnected(bool connected)
@@ -94,10 +110,6 @@ void DBusWatcher::onServiceRegistered(const QString &service)
     } else if (service == SUPERGFX_SERVICE) {
         setSupergfxConnected(true);
     }
-
-    if (allConnected() && m_retryTimer->isActive()) {
-        m_retryTimer->stop();
-    }
 }
 
 void DBusWatcher::onServiceUnregistered(const QString &service)
@@ -109,14 +121,4 @@ void DBusWatcher::onServiceUnregistered(const QString &service)
     } else if (service == SUPERGFX_SERVICE) {
         setSupergfxConnected(false);
     }
-
-    if (!m_retryTimer->isActive()) {
-        m_retryTimer->start();
-    }
-}
-
-void DBusWatcher::onRetryConnection()
-{
-    qDebug() << "Retrying D-Bus connections...";
-    checkConnections();
 }
@@ -4,13 +4,18 @@
 #include <QObject>
 #include <QDBusConnection>
 #include <QDBusServiceWatcher>
-#include <QTimer>
 
+// Tracks asusd and supergfxd purely through NameOwnerChanged (via
+// QDBusServiceWatcher) plus one async NameHasOwner check at startup.
+// There is no polling: a daemon that is not running is picked up the
+// moment it registers, and one that is not installed costs nothing.
 class DBusWatcher : public QObject
 {
     Q_OBJECT
     Q_PROPERTY(bool asusdConnected READ asusdConnected NOTIFY asusdConnectedChanged)
     Q_PROPERTY(bool supergfxConnected READ supergfxConnected NOTIFY supergfxConnectedChanged)
+    Q_PROPERTY(bool asusdInstalled READ asusdInstalled CONSTANT)
+    Q_PROPERTY(bool supergfxInstalled READ supergfxInstalled CONSTANT)
     Q_PROPERTY(bool allConnected READ allConnected NOTIFY connectionStatusChanged)
     Q_PROPERTY(QString connectionStatus READ connectionStatus NOTIFY connectionStatusChanged)
 
@@ -20,7 +25,10 @@ public:
 
     bool asusdConnected() const { return m_asusdConnected; }
     bool supergfxConnected() const { return m_supergfxConnected; }
-    bool allConnected() const { return m_asusdConnected && m_supergfxConnected; }
+    bool asusdInstalled() const { return m_asusdInstalled; }
+    bool supergfxInstalled() const { return m_supergfxInstalled; }
+    // A daemon that is not installed does not count as missing
+    bool allConnected() const;
     QString connectionStatus() const;
 
     Q_INVOKABLE void checkConnections();
@@ -33,21 +41,22 @@ signals:
 private slots:
     void onServiceRegistered(const QString &service);
     void onServiceUnregistered(const QString &service);
-    void onRetryConnection();
 
 private:
     void checkAsusd();
     void checkSupergfx();
     void setAsusdConnected(bool connected);
     void setSupergfxConnected(bool connected);
+    static bool isInstalled(const QString &executable);
 
     static constexpr const char* ASUSD_SERVICE = "xyz.ljones.Asusd";
     static constexpr const char* SUPERGFX_SERVICE = "org.supergfxctl.Daemon";
 
     QDBusServiceWatcher *m_watcher;
-    QTimer *m_retryTimer;
     bool m_asusdConnected = false;
     bool m_supergfxConnected = false;
+    bool m_asusdInstalled = true;
+    bool m_supergfxInstalled = true;
 };
 
 #endif // DBUSWATCHER_H
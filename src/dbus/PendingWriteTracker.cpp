@@ -0,0 +1,105 @@
+#include "PendingWriteTracker.h"
+
+quint64 PendingWriteTracker::begin(const QString &property, const QVariant &value)
+{
+    QVector<Write> &writes = m_pending[property];
+    // Older writes still in flight can no longer decide the final value
+    for (const Write &write : writes) {
+        if (!write.acknowledged) m_superseded++;
+    }
+    if (writes.size() >= MAX_WRITES) {
+        writes.removeFirst();
+    }
+
+    const quint64 generation = m_nextGeneration++;
+    writes.append({generation, value, false});
+    return generation;
+}
+
+void PendingWriteTracker::acknowledge(const QString &property, quint64 generation)
+{
+    auto it = m_pending.find(property);
+    if (it == m_pending.end()) return;
+
+    for (Write &write : it.value()) {
+        if (write.generation == generation && !write.acknowledged) {
+            write.acknowledged = true;
+            m_confirmed++;
+            break;
+        }
+    }
+}
+
+bool PendingWriteTracker::fail(const QString &property, quint64 generation)
+{
+    auto it = m_pending.find(property);
+    if (it == m_pending.end()) return true;
+
+    QVector<Write> &writes = it.value();
+    for (int i = 0; i < writes.size(); i++) {
+        if (writes[i].generation == generation) {
+            writes.remove(i);
+            m_failed++;
+            break;
+        }
+    }
+
+    if (writes.isEmpty()) {
+        m_pending.erase(it);
+        return true;
+    }
+    for (const Write &write : writes) {
+        if (!write.acknowledged) return false;
+    }
+    return true;
+}
+
+PendingWriteTracker::Decision PendingWriteTracker::reconcile(const QString &property, const QVariant &value)
+{
+    auto it = m_pending.find(property);
+    if (it == m_pending.end()) return Apply;
+
+    QVector<Write> &writes = it.value();
+
+    // Newest match wins: writing A, B, A and seeing A confirms all three
+    for (int i = writes.size() - 1; i >= 0; i--) {
+        if (writes[i].value == value) {
+            const bool newest = (i == writes.size() - 1);
+            confirmThrough(writes, writes[i].generation);
+            if (writes.isEmpty()) {
+                m_pending.erase(it);
+            }
+            return newest ? Apply : Suppress;
+        }
+    }
+
+    // Not something we wrote: someone else changed it, take theirs
+    m_external++;
+    m_pending.erase(it);
+    return Apply;
+}
+
+bool PendingWriteTracker::isPending(const QString &property) const
+{
+    return m_pending.contains(property);
+}
+
+void PendingWriteTracker::clear()
+{
+    m_pending.clear();
+}
+
+void PendingWriteTracker::confirmThrough(QVector<Write> &writes, quint64 generation)
+{
+    int count = 0;
+    bool counted = false;
+    while (count < writes.size() && writes[count].generation <= generation) {
+        // A write whose reply already came back was counted then
+        counted = writes[count].acknowledged;
+        count++;
+    }
+    if (count > 0) {
+        writes.remove(0, count);
+        if (!counted) m_confirmed++;
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef PENDINGWRITETRACKER_H
+#define PENDINGWRITETRACKER_H
+
+#include <QHash>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+// Optimistic-update bookkeeping for writable D-Bus properties.
+//
+// Every local write gets a monotonically increasing generation and stays
+// pending until the daemon confirms it with a PropertiesChanged echo
+// carrying its value. A successful method reply only marks the write
+// acknowledged: its echo may still be on the way, and must not look like
+// an external change when it lands after a newer write. Incoming values
+// are reconciled against the pending set instead of being dropped for a
+// fixed time:
+//
+//  - an echo of a pending write confirms it and every older one; it is
+//    suppressed if a newer local write is still outstanding (stale echo)
+//  - a value no pending write carries is an external change (e.g. the
+//    Fn+F5 hotkey); it is applied and clears the property's pending writes
+//  - with nothing pending, values are applied as-is
+class PendingWriteTracker
+{
+public:
+    enum Decision {
+        Apply,
+        Suppress
+    };
+
+    // Registers a local write and returns its generation
+    quint64 begin(const QString &property, const QVariant &value);
+
+    // The Set call for this generation succeeded. The write is kept until
+    // its echo (or that of a newer write) arrives.
+    void acknowledge(const QString &property, quint64 generation);
+
+    // The Set call for this generation failed. Returns true if no other
+    // write is still in flight, i.e. the caller should fall back to the
+    // daemon's value.
+    bool fail(const QString &property, quint64 generation);
+
+    // Decides what to do with a value reported by the daemon
+    Decision reconcile(const QString &property, const QVariant &value);
+
+    bool isPending(const QString &property) const;
+    void clear();
+
+    // Instrumentation
+    int confirmedCount() const { return m_confirmed; }
+    int supersededCount() const { return m_superseded; }
+    int failedCount() const { return m_failed; }
+    int externalCount() const { return m_external; }
+
+private:
+    struct Write {
+        quint64 generation;
+        QVariant value;
+        bool acknowledged;
+    };
+
+    // Drops every write up to and including the given generation
+    void confirmThrough(QVector<Write> &writes, quint64 generation);
+
+    // Bound per property for daemons that do not echo unchanged values
+    static constexpr int MAX_WRITES = 8;
+
+    QHash<QString, QVector<Write>> m_pending; // Oldest first
+    quint64 m_nextGeneration = 1;
+
+    int m_confirmed = 0;
+    int m_superseded = 0;
+    int m_failed = 0;
+    int m_external = 0;
+};
+
+#endif // PENDINGWRITETRACKER_H
@@ -1,14 +1,28 @@
 #include "SuperGfxClient.h"
+#include "SystemBus.h"
+#include "LatencyStats.h"
+#include "RuntimePmWatcher.h"
+#include "Trace.h"
+#include "gfxproxy.h"
 #include <QDBusPendingReply>
-#include <QDBusReply>
 #include <QDebug>
+#include <QTimer>
 
 SuperGfxClient::SuperGfxClient(QObject *parent)
     : QObject(parent)
-    , m_powerPollTimer(new QTimer(this))
+    , m_proxy(new GfxProxy(SERVICE, PATH, SystemBus::connection(), this))
+    , m_runtimePm(new RuntimePmWatcher(this))
+    , m_fallbackTimer(new QTimer(this))
+    , m_reconnectTimer(new QTimer(this))
 {
-    m_powerPollTimer->setInterval(2000); // Poll every 2 seconds
-    connect(m_powerPollTimer, &QTimer::timeout, this, &SuperGfxClient::fetchGpuPower);
+    TRACE_SPAN("SuperGfxClient", "dbus");
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &SuperGfxClient::tryReconnect);
+
+    m_fallbackTimer->setSingleShot(true);
+    connect(m_fallbackTimer, &QTimer::timeout, this, &SuperGfxClient::onFallbackPoll);
+    connect(m_runtimePm, &RuntimePmWatcher::statusChanged,
+            this, &SuperGfxClient::onRuntimeStatusChanged);
 
     setupConnections();
 }
@@ -17,64 +31,172 @@ SuperGfxClient::~SuperGfxClient() = default;
 
 void SuperGfxClient::setupConnections()
 {
-    QDBusConnection bus = QDBusConnection::systemBus();
+    // Never block on the daemon: ask the bus whether it is there and carry on
+    SystemBus::probeService(SERVICE, this, [this](bool available) {
+        qDebug() << "SuperGfxClient: Connected to supergfxd:" << available;
+        if (available) {
+            onServiceAvailable();
+        } else {
+            qWarning() << "SuperGfxClient: Failed to connect to supergfxd";
+        }
+    });
+}
 
-    m_interface = new QDBusInterface(SERVICE, PATH, INTERFACE, bus, this);
-    m_connected = m_interface->isValid();
+void SuperGfxClient::onServiceAvailable()
+{
+    m_reconnectTimer->stop();
+    m_reconnectAttempts = 0;
+    if (m_connected) return;
 
-    qDebug() << "SuperGfxClient: Connected to supergfxd:" << m_connected;
+    m_connected = true;
+    m_supportedModesKnown = false;
 
-    if (m_connected) {
-        // Connect to signals
-        bus.connect(SERVICE, PATH, INTERFACE,
-                    "NotifyGfxStatus", this, SLOT(onNotifyGfxStatus(quint32)));
+    // Connect to signals
+    connect(m_proxy, &GfxProxy::NotifyGfxStatus,
+            this, &SuperGfxClient::onNotifyGfxStatus, Qt::UniqueConnection);
 
-        refresh();
-        startPowerPolling();
-    } else {
-        qWarning() << "SuperGfxClient: Failed to connect to supergfxd";
-    }
+    emit connectedChanged(true);
+    refresh();
+    scheduleFallbackPoll();
 }
 
 void SuperGfxClient::refresh()
 {
-    if (!m_connected) return;
-
-    fetchCurrentMode();
-    fetchSupportedModes();
-    fetchGpuPower();
+    if (!m_connected || m_refreshScheduled) return;
+
+    // supergfxd exposes methods only (no properties to GetAll), so batch
+    // every refresh requested in this event loop turn into one set of calls
+    m_refreshScheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        m_refreshScheduled = false;
+        if (!m_connected) return;
+
+        fetchCurrentMode();
+        // The supported set is fixed for the lifetime of the daemon
+        if (!m_supportedModesKnown) {
+            fetchSupportedModes();
+        }
+        fetchGpuPower();
+    });
 }
 
 void SuperGfxClient::reconnect()
 {
+    // Not gated on m_serviceInstalled: a registration on the bus is proof
+    // enough, even if no unit file was found at startup
     if (m_connected) return;
 
-    // Try to reconnect
-    if (m_interface) {
-        delete m_interface;
-        m_interface = nullptr;
+    // A fresh request (e.g. the daemon just registered) restarts the backoff
+    m_reconnectTimer->stop();
+    m_reconnectAttempts = 0;
+    tryReconnect();
+}
+
+void SuperGfxClient::tryReconnect()
+{
+    if (m_connected) return;
+
+    SystemBus::probeService(SERVICE, this, [this](bool available) {
+        if (available) {
+            onServiceAvailable();
+            return;
+        }
+
+        // Back off 1 s, 2 s, 4 s ... and give up; DBusWatcher calls
+        // reconnect() again as soon as the daemon actually registers.
+        // Without supergfxd installed there is nothing to wait for.
+        if (m_serviceInstalled && m_reconnectAttempts < MAX_RECONNECT_ATTEMPTS) {
+            const int delay = qMin(INITIAL_RECONNECT_DELAY << m_reconnectAttempts, MAX_RECONNECT_DELAY);
+            m_reconnectAttempts++;
+            qDebug() << "SuperGfxClient: supergfxd not available, retrying in" << delay << "ms";
+            m_reconnectTimer->start(delay);
+        }
+    });
+}
+
+void SuperGfxClient::serviceLost()
+{
+    m_reconnectTimer->stop();
+    if (!m_connected) return;
+
+    m_connected = false;
+    m_fallbackTimer->stop();
+    disconnect(m_proxy, &GfxProxy::NotifyGfxStatus,
+               this, &SuperGfxClient::onNotifyGfxStatus);
+    emit connectedChanged(false);
+}
+
+void SuperGfxClient::setPollingActive(bool active)
+{
+    if (m_pollingActive == active) return;
+    m_pollingActive = active;
+
+    if (active) {
+        // Catch up on anything a missed notification would have told us
+        resetFallbackBackoff();
+        if (m_connected) fetchGpuPower();
+    } else {
+        // Hidden: notifications alone, no timer wakeups at all
+        m_fallbackTimer->stop();
+    }
+}
+
+void SuperGfxClient::resetFallbackBackoff()
+{
+    m_fallbackInterval = MIN_FALLBACK_INTERVAL;
+    if (m_fallbackTimer->isActive()) {
+        m_fallbackTimer->start(m_fallbackInterval);
+    } else {
+        scheduleFallbackPoll();
     }
+}
+
+void SuperGfxClient::scheduleFallbackPoll()
+{
+    if (!m_connected || !m_pollingActive) return;
+    m_fallbackTimer->start(m_fallbackInterval);
+}
 
-    QDBusConnection bus = QDBusConnection::systemBus();
-    m_interface = new QDBusInterface(SERVICE, PATH, INTERFACE, bus, this);
-    bool nowConnected = m_interface->isValid();
+void SuperGfxClient::onFallbackPoll()
+{
+    // Quiet polls back off 2 s, 4 s, ... up to 30 s; any change resets
+    m_fallbackInterval = qMin(m_fallbackInterval * 2, MAX_FALLBACK_INTERVAL);
 
-    if (nowConnected && !m_connected) {
-        m_connected = true;
+    if (m_runtimePm->isAvailable()) {
+        // A local file read; statusChanged asks supergfxd only on a change
+        m_runtimePm->readStatus();
+    } else {
+        fetchGpuPower();
+    }
+    scheduleFallbackPoll();
+}
 
-        // Connect to signals
-        bus.connect(SERVICE, PATH, INTERFACE,
-                    "NotifyGfxStatus", this, SLOT(onNotifyGfxStatus(quint32)));
+void SuperGfxClient::onRuntimeStatusChanged(const QString &status)
+{
+    // suspending/resuming settle on their own; wait for the final state
+    if (status != "active" && status != "suspended") return;
 
-        emit connectedChanged(true);
-        refresh();
-        startPowerPolling();
+    if (m_connected) {
+        fetchGpuPower();
+    }
+}
+
+void SuperGfxClient::setServiceInstalled(bool installed)
+{
+    m_serviceInstalled = installed;
+    if (!installed) {
+        // Nothing to wait for; make sure no retry stays scheduled
+        m_reconnectTimer->stop();
     }
 }
 
 void SuperGfxClient::fetchCurrentMode()
 {
-    QDBusPendingCall call = m_interface->asyncCall("Mode");
+    if (m_modeInFlight) return;
+    m_modeInFlight = true;
+    m_modeTimer.start();
+
+    QDBusPendingCall call = m_proxy->Mode();
     auto *watcher = new QDBusPendingCallWatcher(call, this);
     connect(watcher, &QDBusPendingCallWatcher::finished,
             this, &SuperGfxClient::onModeResult);
@@ -82,7 +204,10 @@ void SuperGfxClient::fetchCurrentMode()
 
 void SuperGfxClient::onModeResult(QDBusPendingCallWatcher *watcher)
 {
+    m_modeInFlight = false;
+
     QDBusPendingReply<quint32> reply = *watcher;
+    LatencyStats::instance()->record(LatencyStats::GfxMode, m_modeTimer.nsecsElapsed(), reply.isError());
     if (reply.isError()) {
         qWarning() << "Failed to get GPU mode:" << reply.error().message();
     } else {
@@ -103,7 +228,11 @@ void SuperGfxClient::onModeResult(QDBusPendingCallWatcher *watcher)
 
 void SuperGfxClient::fetchSupportedModes()
 {
-    QDBusPendingCall call = m_interface->asyncCall("Supported");
+    if (m_supportedInFlight) return;
+    m_supportedInFlight = true;
+    m_supportedTimer.start();
+
+    QDBusPendingCall call = m_proxy->Supported();
     auto *watcher = new QDBusPendingCallWatcher(call, this);
     connect(watcher, &QDBusPendingCallWatcher::finished,
             this, &SuperGfxClient::onSupportedModesResult);
@@ -111,12 +240,16 @@ void SuperGfxClient::fetchSupportedModes()
 
 void SuperGfxClient::onSupportedModesResult(QDBusPendingCallWatcher *watcher)
 {
+    m_supportedInFlight = false;
+
     QDBusPendingReply<QList<quint32>> reply = *watcher;
+    LatencyStats::instance()->record(LatencyStats::GfxSupported, m_supportedTimer.nsecsElapsed(), reply.isError());
     if (reply.isError()) {
         qWarning() << "Failed to get supported GPU modes:" << reply.error().message();
         // Default to common modes
         m_supportedModes = {Integrated, Hybrid};
     } else {
+        m_supportedModesKnown = true;
         m_supportedModes.clear();
         for (quint32 mode : reply.value()) {
             m_supportedModes.append(static_cast<int>(mode));
@@ -128,7 +261,12 @@ void SuperGfxClient::onSupportedModesResult(QDBusPendingCallWatcher *watcher)
 
 void SuperGfxClient::fetchGpuPower()
 {
-    QDBusPendingCall call = m_interface->asyncCall("Power");
+    // The poll timer and status notifications can overlap; one call is enough
+    if (m_powerInFlight) return;
+    m_powerInFlight = true;
+    m_powerTimer.start();
+
+    QDBusPendingCall call = m_proxy->Power();
     auto *watcher = new QDBusPendingCallWatcher(call, this);
     connect(watcher, &QDBusPendingCallWatcher::finished,
             this, &SuperGfxClient::onPowerResult);
@@ -136,12 +274,14 @@ void SuperGfxClient::fetchGpuPower()
 
 void SuperGfxClient::onPowerResult(QDBusPendingCallWatcher *watcher)
 {
+    m_powerInFlight = false;
+
     QDBusPendingReply<quint32> reply = *watcher;
+    LatencyStats::instance()->record(LatencyStats::GfxPower, m_powerTimer.nsecsElapsed(), reply.isError());
     if (reply.isError()) {
         qWarning() << "SuperGfxClient: Failed to get GPU power status:" << reply.error().message();
     } else {
         quint32 power = reply.value();
-        qDebug() << "SuperGfxClient: GPU power raw value:" << power;
         QString powerStr;
         switch (power) {
             case 0: powerStr = "Active"; break;
@@ -151,10 +291,16 @@ void SuperGfxClient::onPowerResult(QDBusPendingCallWatcher *watcher)
             case 4: powerStr = "AsusMuxDiscreet"; break;
             default: powerStr = "Unknown"; break;
         }
-        qDebug() << "SuperGfxClient: GPU power string:" << powerStr;
         if (m_gpuPower != powerStr) {
+            qDebug() << "SuperGfxClient: GPU power" << power << powerStr;
             m_gpuPower = powerStr;
             emit gpuPowerChanged(powerStr);
+
+            // The dGPU may have just (re)appeared on the bus
+            if (!m_runtimePm->isAvailable()) {
+                m_runtimePm->rescan();
+            }
+            resetFallbackBackoff();
         }
     }
     watcher->deleteLater();
@@ -167,13 +313,14 @@ void SuperGfxClient::setMode(int mode)
     // Check if logout is required
     bool needsLogout = requiresLogout(m_currentMode, mode);
 
-    QDBusMessage msg = QDBusMessage::createMethodCall(SERVICE, PATH, INTERFACE, "SetMode");
-    msg << static_cast<quint32>(mode);
+    QElapsedTimer timer;
+    timer.start();
 
-    QDBusPendingCall call = QDBusConnection::systemBus().asyncCall(msg);
+    QDBusPendingCall call = m_proxy->SetMode(static_cast<quint32>(mode));
     auto *watcher = new QDBusPendingCallWatcher(call, this);
-    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, mode, needsLogout](QDBusPendingCallWatcher *w) {
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, mode, needsLogout, timer](QDBusPendingCallWatcher *w) {
         QDBusPendingReply<> reply = *w;
+        LatencyStats::instance()->record(LatencyStats::GfxSetMode, timer.nsecsElapsed(), reply.isError());
         if (reply.isError()) {
             qWarning() << "Failed to set GPU mode:" << reply.error().message();
             emit errorOccurred(tr("Failed to set GPU mode: %1").arg(reply.error().message()));
@@ -242,17 +389,3 @@ bool SuperGfxClient::requiresLogout(int fromMode, int toMode) const
     }
     return false;
 }
-
-void SuperGfxClient::startPowerPolling()
-{
-    if (m_connected && !m_powerPollTimer->isActive()) {
-        m_powerPollTimer->start();
-    }
-}
-
-void SuperGfxClient::stopPowerPolling()
-{
-    if (m_powerPollTimer->isActive()) {
-        m_powerPollTimer->stop();
-    }
-}
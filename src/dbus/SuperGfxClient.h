@@ -3,11 +3,14 @@
 
 #include <QObject>
 #include <QDBusConnection>
-#include <QDBusInterface>
 #include <QDBusPendingCallWatcher>
 #include <QTimer>
+#include <QElapsedTimer>
 #include "DBusTypes.h"
 
+class GfxProxy;
+class RuntimePmWatcher;
+
 class SuperGfxClient : public QObject
 {
     Q_OBJECT
@@ -42,6 +45,13 @@ public:
     Q_INVOKABLE void setMode(int mode);
     Q_INVOKABLE void refresh();
     Q_INVOKABLE void reconnect();
+    // The daemon left the bus
+    void serviceLost();
+    // When false, a failed reconnect() is not retried: there is nothing to
+    // wait for. A reconnect() after the daemon registers still connects.
+    void setServiceInstalled(bool installed);
+    // Allows the fallback power poll; only worth it while someone is looking
+    void setPollingActive(bool active);
     Q_INVOKABLE QString modeName(int mode) const;
     Q_INVOKABLE QString modeDescription(int mode) const;
     Q_INVOKABLE bool requiresLogout(int fromMode, int toMode) const;
@@ -61,28 +71,57 @@ private slots:
     void onSupportedModesResult(QDBusPendingCallWatcher *watcher);
     void onPowerResult(QDBusPendingCallWatcher *watcher);
     void onNotifyGfxStatus(quint32 status);
+    void onRuntimeStatusChanged(const QString &status);
+    void onFallbackPoll();
+    void tryReconnect();
 
 private:
     void setupConnections();
+    void onServiceAvailable();
     void fetchCurrentMode();
     void fetchSupportedModes();
     void fetchGpuPower();
 
     static constexpr const char* SERVICE = "org.supergfxctl.Daemon";
     static constexpr const char* PATH = "/org/supergfxctl/Gfx";
-    static constexpr const char* INTERFACE = "org.supergfxctl.Daemon";
 
-    void startPowerPolling();
-    void stopPowerPolling();
+    void scheduleFallbackPoll();
+    void resetFallbackBackoff();
+
+    GfxProxy *m_proxy; // Generated from interfaces/org.supergfxctl.Daemon.xml
+
+    // dGPU power is tracked from NotifyGfxStatus and the runtime PM status
+    // file; the poll below is only a backstop while the window is shown
+    RuntimePmWatcher *m_runtimePm = nullptr;
+    QTimer *m_fallbackTimer = nullptr;
+    int m_fallbackInterval = MIN_FALLBACK_INTERVAL;
+    bool m_pollingActive = false;
 
-    QDBusInterface *m_interface = nullptr;
-    QTimer *m_powerPollTimer = nullptr;
+    QTimer *m_reconnectTimer = nullptr;
+    int m_reconnectAttempts = 0;
+    bool m_serviceInstalled = true;
     bool m_connected = false;
     int m_currentMode = Hybrid;
     int m_pendingMode = -1;
     QList<int> m_supportedModes;
     bool m_switchPending = false;
     QString m_gpuPower;
+
+    // Refresh coalescing / in-flight dedupe
+    bool m_refreshScheduled = false;
+    bool m_modeInFlight = false;
+    bool m_supportedInFlight = false;
+    bool m_powerInFlight = false;
+    bool m_supportedModesKnown = false;
+    QElapsedTimer m_modeTimer;
+    QElapsedTimer m_supportedTimer;
+    QElapsedTimer m_powerTimer;
+
+    static constexpr int MIN_FALLBACK_INTERVAL = 2000;  // ms
+    static constexpr int MAX_FALLBACK_INTERVAL = 30000; // ms
+    static constexpr int INITIAL_RECONNECT_DELAY = 1000; // ms
+    static constexpr int MAX_RECONNECT_DELAY = 60000;    // ms
+    static constexpr int MAX_RECONNECT_ATTEMPTS = 6;
 };
 
 #endif // SUPERGFXCLIENT_H
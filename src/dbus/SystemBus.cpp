@@ -0,0 +1,60 @@
+#include "SystemBus.h"
+#include "LatencyStats.h"
+#include "Trace.h"
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QObject>
+
+QString SystemBus::overrideAddress()
+{
+    return qEnvironmentVariable(ADDRESS_ENV);
+}
+
+QDBusConnection SystemBus::connection()
+{
+    static const QString address = overrideAddress();
+    if (address.isEmpty()) {
+        return QDBusConnection::systemBus();
+    }
+
+    // Named connections are shared; the first call opens it
+    QDBusConnection bus(CONNECTION_NAME);
+    if (!bus.isConnected()) {
+        bus = QDBusConnection::connectToBus(address, CONNECTION_NAME);
+        if (bus.isConnected()) {
+            qDebug() << "SystemBus: Using bus at" << address;
+        } else {
+            qWarning() << "SystemBus: Failed to connect to" << address << ":" << bus.lastError().message();
+        }
+    }
+    return bus;
+}
+
+void SystemBus::probeService(const QString &service, QObject *context,
+                             std::function<void(bool)> callback)
+{
+    QDBusMessage msg = QDBusMessage::createMethodCall(
+        "org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus", "NameHasOwner");
+    msg << service;
+
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 traceStart = Trace::now();
+
+    QDBusPendingCall call = connection().asyncCall(msg);
+    auto *watcher = new QDBusPendingCallWatcher(call, context);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished,
+                     context, [service, timer, traceStart, callback](QDBusPendingCallWatcher *w) {
+        QDBusPendingReply<bool> reply = *w;
+        LatencyStats::instance()->record(LatencyStats::NameHasOwner, timer.nsecsElapsed(), reply.isError());
+        Trace::complete("NameHasOwner", "dbus", traceStart, Trace::now());
+        if (reply.isError()) {
+            qWarning() << "SystemBus: NameHasOwner" << service << "failed:" << reply.error().message();
+        }
+        callback(!reply.isError() && reply.value());
+        w->deleteLater();
+    });
+}
@@ -0,0 +1,35 @@
+#ifndef SYSTEMBUS_H
+#define SYSTEMBUS_H
+
+#include <QDBusConnection>
+#include <QString>
+#include <functional>
+
+class QObject;
+
+// The bus the daemon clients talk to.
+//
+// Normally this is the system bus. Setting GHELPER_DBUS_ADDRESS (a D-Bus
+// address such as "unix:path=/tmp/ghelper-bus") points AsusdClient,
+// SuperGfxClient and DBusWatcher at another bus instead, e.g. a private
+// dbus-daemon hosting stand-in asusd/supergfxd services.
+class SystemBus
+{
+public:
+    static QDBusConnection connection();
+
+    // Empty when the real system bus is in use
+    static QString overrideAddress();
+
+    // Asks the bus whether the service has an owner without blocking; the
+    // callback runs on context's thread and is dropped if context is gone
+    static void probeService(const QString &service, QObject *context,
+                             std::function<void(bool)> callback);
+
+    static constexpr const char* ADDRESS_ENV = "GHELPER_DBUS_ADDRESS";
+
+private:
+    static constexpr const char* CONNECTION_NAME = "g-helper-linux-bus";
+};
+
+#endif // SYSTEMBUS_H
@@ -0,0 +1,134 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <cstdio>
+
+#include "core/Settings.h"
+#include "core/LatencyStats.h"
+#include "core/RemoteControl.h"
+#include "core/SingleInstance.h"
+#include "dbus/DBusWatcher.h"
+#include "dbus/AsusdClient.h"
+#include "dbus/SuperGfxClient.h"
+#include "controllers/PerformanceController.h"
+#include "controllers/GpuController.h"
+#include "controllers/BatteryController.h"
+#include "controllers/FanController.h"
+#include "controllers/SystemMonitor.h"
+#include "controllers/AcousticGovernor.h"
+
+// Daemon build for machines without a desktop session: the same D-Bus
+// clients, controllers and automation on a QCoreApplication, controlled
+// through the single-instance socket (see RemoteControl). Links ghelper_core
+// only, so no QtGui, QtQuick or QtWidgets is loaded.
+int main(int argc, char *argv[])
+{
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
+    // A running daemon (or GUI) takes the command and prints the reply
+    const bool standalone = SingleInstance::isStandaloneLaunch(argc, argv);
+    if (!standalone && SingleInstance::forward(argc, argv)) {
+        return 0;
+    }
+
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("G-Helper Linux");
+    app.setApplicationVersion("0.1.0");
+    app.setOrganizationName("g-helper-linux");
+    app.setOrganizationDomain("github.com/g-helper-linux");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless control daemon for ASUS ROG laptops");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption dumpStatsOption("dump-stats",
+        "Print D-Bus call latency and error statistics on exit.");
+    parser.addOption(dumpStatsOption);
+    QCommandLineOption statsJsonOption("stats-json",
+        "Write D-Bus call latency and error statistics to <file> as JSON on exit.", "file");
+    parser.addOption(statsJsonOption);
+    RemoteControl::addOptions(parser);
+    parser.process(app);
+
+    // Queries need a daemon to answer them
+    if (parser.isSet("status")) {
+        fputs("g-helper-linux-headless: no running instance\n", stderr);
+        return 1;
+    }
+
+    SingleInstance singleInstance;
+    if (!singleInstance.listen()) {
+        if (SingleInstance::forward(argc, argv)) return 0;
+        qWarning() << "SingleInstance: Running instance did not answer, starting anyway";
+    }
+
+    Settings settings;
+    DBusWatcher dbusWatcher;
+    AsusdClient asusdClient;
+    SuperGfxClient superGfxClient;
+
+    PerformanceController performanceController(&asusdClient);
+    GpuController gpuController(&superGfxClient);
+    BatteryController batteryController(&asusdClient);
+    SystemMonitor systemMonitor;
+    FanController fanController(&asusdClient);
+    fanController.setFanCount(systemMonitor.fanCount());
+
+    AcousticGovernor acousticGovernor(&systemMonitor, &performanceController);
+    acousticGovernor.setRpmLimit(settings.fanRpmLimit());
+
+    RemoteControl remoteControl(&asusdClient, &performanceController, &gpuController, &systemMonitor);
+    const QString startupReply = remoteControl.execute(parser);
+    if (!startupReply.isEmpty()) {
+        fputs(qPrintable(startupReply), stdout);
+    }
+    singleInstance.setHandler([&](const QStringList &arguments) {
+        return remoteControl.execute(arguments);
+    });
+
+    systemMonitor.start();
+
+    QObject::connect(&dbusWatcher, &DBusWatcher::asusdConnectedChanged, [&](bool connected) {
+        if (connected) {
+            asusdClient.reconnect();
+            performanceController.refresh();
+            batteryController.refresh();
+            fanController.refresh();
+        } else {
+            asusdClient.serviceLost();
+        }
+    });
+
+    superGfxClient.setServiceInstalled(dbusWatcher.supergfxInstalled());
+    QObject::connect(&dbusWatcher, &DBusWatcher::supergfxConnectedChanged, [&](bool connected) {
+        if (connected) {
+            superGfxClient.reconnect();
+            gpuController.refresh();
+        } else {
+            superGfxClient.serviceLost();
+        }
+    });
+
+    if (parser.isSet(dumpStatsOption)) {
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
+            fputs(qPrintable(LatencyStats::instance()->dump()), stdout);
+            fflush(stdout);
+        });
+    }
+
+    if (parser.isSet(statsJsonOption)) {
+        const QString statsPath = parser.value(statsJsonOption);
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [statsPath]() {
+            if (!LatencyStats::instance()->writeJson(statsPath)) {
+                qWarning() << "Failed to write statistics to" << statsPath;
+            }
+        });
+    }
+
+    qInfo().noquote() << QString("Headless: ready after %1 ms, listening on %2")
+        .arg(startupTimer.elapsed()).arg(SingleInstance::socketPath());
+
+    return app.exec();
+}
@@ -1,15 +1,23 @@
 #include <QApplication>
-#include <QQmlApplicationEngine>
-#include <QQmlContext>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
 #include <QQuickStyle>
 #include <QIcon>
-#include <QScreen>
-#include <QWindow>
+#include <QQuickWindow>
+#include <QTimer>
+#include <algorithm>
+#include <cstdio>
+#include <memory>
 
 using namespace Qt::StringLiterals;
 
 #include "core/Application.h"
 #include "core/Settings.h"
+#include "core/LatencyStats.h"
+#include "core/LazySingleton.h"
+#include "core/RemoteControl.h"
+#include "core/SingleInstance.h"
+#include "core/Trace.h"
 #include "dbus/DBusWatcher.h"
 #include "dbus/AsusdClient.h"
 #include "dbus/SuperGfxClient.h"
@@ -20,11 +28,29 @@ using namespace Qt::StringLiterals;
 #include "controllers/AuraController.h"
 #include "controllers/SystemMonitor.h"
 #include "controllers/SlashController.h"
+#include "controllers/AcousticGovernor.h"
 #include "tray/TrayManager.h"
+#include "tray/WindowHost.h"
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
+    // Hand over to the running instance before Qt is touched
+    const bool standalone = SingleInstance::isStandaloneLaunch(argc, argv);
+    if (!standalone && SingleInstance::forward(argc, argv)) {
+        return 0;
+    }
+
+    // Tracing has to be on before QApplication exists to see what it costs
+    if (SingleInstance::hasArgument(argc, argv, "--trace")) {
+        Trace::setEnabled(true);
+    }
+
+    const qint64 appStart = Trace::now();
     QApplication app(argc, argv);
+    Trace::complete("QApplication", "startup", appStart, Trace::now());
 
     app.setApplicationName("G-Helper Linux");
     app.setApplicationVersion("0.1.0");
@@ -32,6 +58,37 @@ int main(int argc, char *argv[])
     app.setOrganizationDomain("github.com/g-helper-linux");
     app.setWindowIcon(QIcon(":/icons/g-helper.svg"));
 
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Control tool for ASUS ROG laptops");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption dumpStatsOption("dump-stats",
+        "Print D-Bus call latency and error statistics on exit.");
+    parser.addOption(dumpStatsOption);
+    QCommandLineOption statsJsonOption("stats-json",
+        "Write D-Bus call latency and error statistics to <file> as JSON on exit.", "file");
+    parser.addOption(statsJsonOption);
+    QCommandLineOption startupBenchmarkOption("startup-benchmark",
+        "Print time-to-tray and time-to-first-frame, then quit.");
+    parser.addOption(startupBenchmarkOption);
+    QCommandLineOption showBenchmarkOption("show-benchmark",
+        "Hide and re-show the window <runs> times, print show-to-first-frame latency, then quit.", "runs");
+    parser.addOption(showBenchmarkOption);
+    QCommandLineOption traceOption("trace",
+        "Write a Chrome/Perfetto trace of startup to <file> on exit.", "file");
+    parser.addOption(traceOption);
+    RemoteControl::addOptions(parser);
+    parser.process(app);
+    const bool startupBenchmark = parser.isSet(startupBenchmarkOption);
+    const bool showBenchmark = parser.isSet(showBenchmarkOption);
+
+    // Lost a race with another launch: hand over to it after all
+    SingleInstance singleInstance;
+    if (!standalone && !singleInstance.listen()) {
+        if (SingleInstance::forward(argc, argv)) return 0;
+        qWarning() << "SingleInstance: Running instance did not answer, starting anyway";
+    }
+
     QQuickStyle::setStyle("Basic");
 
     // Initialize core components
@@ -42,66 +99,170 @@ int main(int argc, char *argv[])
     AsusdClient asusdClient;
     SuperGfxClient superGfxClient;
 
-    // Initialize controllers
+    // Controllers the tray and the governor need right away
     PerformanceController performanceController(&asusdClient);
     GpuController gpuController(&superGfxClient);
-    BatteryController batteryController(&asusdClient);
-    FanController fanController(&asusdClient);
-    AuraController auraController(&asusdClient);
     SystemMonitor systemMonitor;
-    SlashController slashController;
 
-    // Initialize tray manager
-    TrayManager trayManager(&performanceController, &gpuController);
+    // Only the UI uses these; they are built on first QML access. Their
+    // asusctl probes run in the background and don't hold up startup.
+    LazySingleton<BatteryController> batteryController([&]() {
+        return new BatteryController(&asusdClient);
+    });
+    LazySingleton<FanController> fanController([&]() {
+        auto *controller = new FanController(&asusdClient);
+        // Curves are kept for every fan hwmon reports (CPU, GPU and Mid on some Strix)
+        controller->setFanCount(systemMonitor.fanCount());
+        return controller;
+    });
+    LazySingleton<AuraController> auraController([&]() {
+        return new AuraController(&asusdClient);
+    });
+    LazySingleton<SlashController> slashController([]() {
+        return new SlashController();
+    });
 
-    // Setup QML engine
-    QQmlApplicationEngine engine;
-    engine.addImportPath("qrc:/");
+    // Fan RPM budget: steps the profile down while the fans are over the limit
+    AcousticGovernor acousticGovernor(&systemMonitor, &performanceController);
+    acousticGovernor.setRpmLimit(settings.fanRpmLimit());
+    QObject::connect(&settings, &Settings::fanRpmLimitChanged, &acousticGovernor, [&]() {
+        acousticGovernor.setRpmLimit(settings.fanRpmLimit());
+    });
+
+    // The tray icon comes first; everything else can follow it
+    const qint64 trayStart = Trace::now();
+    TrayManager trayManager(&performanceController, &gpuController, &systemMonitor);
+    Trace::complete("TrayManager", "startup", trayStart, Trace::now());
+    trayManager.setIconContent(settings.trayIconContent());
+    // Battery ETA in the tray menu; builds the battery controller the first
+    // time the menu is opened on battery
+    trayManager.addSensorRow([&]() {
+        return systemMonitor.isOnBattery() ? batteryController.get()->timeRemaining() : QString();
+    });
+    QObject::connect(&settings, &Settings::trayIconContentChanged, &trayManager, [&]() {
+        trayManager.setIconContent(settings.trayIconContent());
+    });
+    QTimer::singleShot(0, &app, [&startupTimer, startupBenchmark]() {
+        // First event loop turn: the icon has been handed to the tray host
+        Trace::instant("Tray icon shown", "startup");
+        const QString line = QString("Startup: tray icon after %1 ms").arg(startupTimer.elapsed());
+        qInfo().noquote() << line;
+        if (startupBenchmark) {
+            fputs(qPrintable(line + '\n'), stdout);
+        }
+    });
 
     // Register singletons
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "Settings", &settings);
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "DBusWatcher", &dbusWatcher);
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "PerformanceController", &performanceController);
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "GpuController", &gpuController);
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "BatteryController", &batteryController);
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "FanController", &fanController);
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "AuraController", &auraController);
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "SystemMonitor", &systemMonitor);
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "SlashController", &slashController);
-    qmlRegisterSingletonInstance("GHelperLinux", 1, 0, "TrayManager", &trayManager);
-
-    // Load main QML
-    const QUrl url(u"qrc:/GHelperLinux/qml/Main.qml"_s);
-
-    QObject::connect(&engine, &QQmlApplicationEngine::objectCreationFailed,
+    registerQmlInstance("GHelperLinux", 1, 0, "Settings", &settings);
+    registerQmlInstance("GHelperLinux", 1, 0, "DBusWatcher", &dbusWatcher);
+    registerQmlInstance("GHelperLinux", 1, 0, "PerformanceController", &performanceController);
+    registerQmlInstance("GHelperLinux", 1, 0, "GpuController", &gpuController);
+    batteryController.registerQml("GHelperLinux", 1, 0, "BatteryController");
+    fanController.registerQml("GHelperLinux", 1, 0, "FanController");
+    auraController.registerQml("GHelperLinux", 1, 0, "AuraController");
+    registerQmlInstance("GHelperLinux", 1, 0, "SystemMonitor", &systemMonitor);
+    slashController.registerQml("GHelperLinux", 1, 0, "SlashController");
+    registerQmlInstance("GHelperLinux", 1, 0, "AcousticGovernor", &acousticGovernor);
+    registerQmlInstance("GHelperLinux", 1, 0, "LatencyStats", LatencyStats::instance());
+    registerQmlInstance("GHelperLinux", 1, 0, "TrayManager", &trayManager);
+
+    // The window exists only while it is needed: built when first shown,
+    // torn down after it has stayed hidden for a while (controllers stay)
+    WindowHost windowHost(QUrl(u"qrc:/GHelperLinux/qml/Main.qml"_s));
+    windowHost.setUnloadDelay(settings.minimizeToTray() ? settings.uiUnloadDelay() : 0);
+    auto updateUnloadDelay = [&]() {
+        windowHost.setUnloadDelay(settings.minimizeToTray() ? settings.uiUnloadDelay() : 0);
+    };
+    QObject::connect(&settings, &Settings::uiUnloadDelayChanged, &windowHost, updateUnloadDelay);
+    QObject::connect(&settings, &Settings::minimizeToTrayChanged, &windowHost, updateUnloadDelay);
+
+    QObject::connect(&windowHost, &WindowHost::loadFailed,
         &app, []() { QCoreApplication::exit(-1); },
         Qt::QueuedConnection);
+    QObject::connect(&trayManager, &TrayManager::showWindowRequested, &windowHost, &WindowHost::showSince);
+    QObject::connect(&trayManager, &TrayManager::quitRequested, &app, &QCoreApplication::quit);
 
-    engine.load(url);
+    // dGPU power follows notifications; the fallback poll runs only while shown
+    QObject::connect(&windowHost, &WindowHost::visibleChanged,
+                     &superGfxClient, &SuperGfxClient::setPollingActive);
 
-    if (engine.rootObjects().isEmpty())
-        return -1;
+    // Sensor values reach a hidden window only as one batch right before it
+    // is shown again, instead of re-running its bindings every second
+    QObject::connect(&windowHost, &WindowHost::visibleChanged, &systemMonitor, [&](bool visible) {
+        if (!visible) systemMonitor.setNotificationsSuspended(true);
+    });
+    QObject::connect(&windowHost, &WindowHost::aboutToShow, &systemMonitor, [&]() {
+        systemMonitor.setNotificationsSuspended(false);
+    });
 
-    // Position window at bottom right
-    QObject *rootObject = engine.rootObjects().first();
-    QWindow *window = qobject_cast<QWindow*>(rootObject);
+    if (showBenchmark) {
+        // Warm shows only: the UI stays loaded and is hidden long enough
+        // for a few samples to be held back each time
+        const int runs = qMax(1, parser.value(showBenchmarkOption).toInt());
+        windowHost.setUnloadDelay(0);
+        QObject::disconnect(&settings, nullptr, &windowHost, nullptr);
+        auto latencies = std::make_shared<QList<qint64>>();
+        QObject::connect(&windowHost, &WindowHost::shown, &app, [&windowHost, &trayManager, latencies, runs](qint64 msecs, bool cold) {
+            if (!cold) latencies->append(msecs);
+            if (latencies->size() >= runs) {
+                std::sort(latencies->begin(), latencies->end());
+                const QString line = QString("Show: first frame after %1 ms median, %2 ms min, %3 ms max (%4 warm shows)")
+                    .arg(latencies->at(latencies->size() / 2)).arg(latencies->first())
+                    .arg(latencies->last()).arg(latencies->size());
+                fputs(qPrintable(line + '\n'), stdout);
+                fflush(stdout);
+                QCoreApplication::quit();
+                return;
+            }
+            QTimer::singleShot(300, &windowHost, &WindowHost::hide);
+            // Shown the way a tray click shows it, timed from the click
+            QTimer::singleShot(2500, &trayManager, &TrayManager::requestShow);
+        });
+    }
 
-    auto positionWindow = [window]() {
-        if (!window) return;
-        QScreen *screen = QGuiApplication::primaryScreen();
-        if (screen) {
-            QRect availableGeometry = screen->availableGeometry();
-            int x = availableGeometry.right() - window->width() - 12;
-            int y = availableGeometry.bottom() - window->height() - 60;
-            window->setPosition(x, y);
-        }
-    };
+    QObject::connect(&windowHost, &WindowHost::windowCreated, &app, [&startupTimer, startupBenchmark](QQuickWindow *window) {
+        static bool firstWindow = true;
+        if (!firstWindow) return;
+        firstWindow = false;
+
+        auto firstFrame = std::make_shared<QMetaObject::Connection>();
+        *firstFrame = QObject::connect(window, &QQuickWindow::frameSwapped, qApp, [&startupTimer, startupBenchmark, firstFrame]() {
+            QObject::disconnect(*firstFrame);
+            Trace::instant("First frame", "startup");
+            const QString line = QString("Startup: first frame after %1 ms").arg(startupTimer.elapsed());
+            qInfo().noquote() << line;
+            if (startupBenchmark) {
+                fputs(qPrintable(line + '\n'), stdout);
+                fflush(stdout);
+                QCoreApplication::quit();
+            }
+        });
+    });
 
-    // Position on startup
-    positionWindow();
+    // Load the UI once the event loop runs, i.e. after the tray is up; a
+    // minimized start leaves it unloaded until the tray asks for it
+    const bool startMinimized = settings.startMinimized() || parser.isSet("minimized");
+    if (!startMinimized || !trayManager.isVisible() || startupBenchmark || showBenchmark) {
+        QTimer::singleShot(0, &windowHost, &WindowHost::show);
+    }
 
-    // Reposition when shown from tray
-    QObject::connect(&trayManager, &TrayManager::showWindowRequested, positionWindow);
+    // Control options given at startup (applied once each daemon answers)
+    // and those forwarded by later launches
+    RemoteControl remoteControl(&asusdClient, &performanceController, &gpuController, &systemMonitor);
+    const QString startupReply = remoteControl.execute(parser);
+    if (!startupReply.isEmpty()) {
+        fputs(qPrintable(startupReply), stdout);
+    }
+    singleInstance.setHandler([&](const QStringList &arguments) {
+        bool acted = false;
+        const QString reply = remoteControl.execute(arguments, &acted);
+        // A plain launch raises the window; control commands and the
+        // autostart entry (--minimized) leave it alone
+        if (!acted && !arguments.contains("--minimized")) {
+            windowHost.show();
+        }
+        return reply;
+    });
 
     // Start monitoring
     systemMonitor.start();
@@ -109,24 +270,54 @@ int main(int argc, char *argv[])
     // Connect D-Bus watcher signals
     QObject::connect(&dbusWatcher, &DBusWatcher::asusdConnectedChanged, [&](bool connected) {
         if (connected) {
+            asusdClient.reconnect();
             performanceController.refresh();
-            batteryController.refresh();
-            fanController.refresh();
-            auraController.refresh();
+            // Controllers nobody has looked at yet read fresh state when built
+            if (auto *controller = batteryController.peek()) controller->refresh();
+            if (auto *controller = fanController.peek()) controller->refresh();
+            if (auto *controller = auraController.peek()) controller->refresh();
+        } else {
+            asusdClient.serviceLost();
         }
     });
 
+    // No supergfxd on this machine (e.g. AMD-only): never try to reach it
+    superGfxClient.setServiceInstalled(dbusWatcher.supergfxInstalled());
+
     QObject::connect(&dbusWatcher, &DBusWatcher::supergfxConnectedChanged, [&](bool connected) {
         if (connected) {
             superGfxClient.reconnect();
             gpuController.refresh();
+        } else {
+            superGfxClient.serviceLost();
         }
     });
 
-    // Initial reconnect if services are already available but clients missed it
-    if (dbusWatcher.supergfxConnected() && !superGfxClient.isConnected()) {
-        superGfxClient.reconnect();
-        gpuController.refresh();
+    if (parser.isSet(dumpStatsOption)) {
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, []() {
+            fputs(qPrintable(LatencyStats::instance()->dump()), stdout);
+            fflush(stdout);
+        });
+    }
+
+    if (parser.isSet(statsJsonOption)) {
+        const QString statsPath = parser.value(statsJsonOption);
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [statsPath]() {
+            if (!LatencyStats::instance()->writeJson(statsPath)) {
+                qWarning() << "Failed to write statistics to" << statsPath;
+            }
+        });
+    }
+
+    if (parser.isSet(traceOption)) {
+        const QString tracePath = parser.value(traceOption);
+        QObject::connect(&app, &QCoreApplication::aboutToQuit, [tracePath]() {
+            if (Trace::writeJson(tracePath)) {
+                qInfo() << "Trace written to" << tracePath;
+            } else {
+                qWarning() << "Failed to write trace to" << tracePath;
+            }
+        });
     }
 
     return app.exec();
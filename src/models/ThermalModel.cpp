@@ -0,0 +1,139 @@
+#include "ThermalModel.h"
+#include <QtMath>
+
+ThermalModel::ThermalModel()
+{
+    reset();
+}
+
+void ThermalModel::reset()
+{
+    // Start from "temperature holds steady", which is a safe prediction
+    m_theta[0] = 1.0;
+    m_theta[1] = 0.0;
+    m_theta[2] = 0.0;
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            m_cov[i][j] = (i == j) ? INITIAL_COVARIANCE : 0.0;
+        }
+    }
+
+    for (int i = 0; i < MAX_HORIZON; i++) {
+        m_history[i] = 0.0;
+        m_historyValid[i] = false;
+    }
+
+    m_lastTemp = 0.0;
+    m_lastPower = 0.0;
+    m_samples = 0;
+    m_predicted = 0.0;
+    m_error = 0.0;
+}
+
+void ThermalModel::setHorizon(int steps)
+{
+    steps = qBound(1, steps, maxHorizon());
+    if (m_horizon != steps) {
+        m_horizon = steps;
+        // Pending predictions were made for a different horizon
+        for (int i = 0; i < MAX_HORIZON; i++) {
+            m_historyValid[i] = false;
+        }
+    }
+}
+
+void ThermalModel::addSample(double temperature, double power)
+{
+    const int index = m_samples;
+
+    if (index > 0) {
+        updateFit(m_lastTemp, m_lastPower, temperature);
+    }
+
+    // Score the prediction that was made for this sample
+    const int slot = index % MAX_HORIZON;
+    if (m_historyValid[slot]) {
+        const double error = qAbs(m_history[slot] - temperature);
+        m_error += ERROR_SMOOTHING * (error - m_error);
+        m_historyValid[slot] = false;
+    }
+
+    m_lastTemp = temperature;
+    m_lastPower = power;
+    m_samples++;
+
+    if (isReady()) {
+        m_predicted = predict(m_horizon);
+        const int target = (index + m_horizon) % MAX_HORIZON;
+        m_history[target] = m_predicted;
+        m_historyValid[target] = true;
+    } else {
+        m_predicted = temperature;
+    }
+}
+
+void ThermalModel::updateFit(double prevTemp, double prevPower, double temp)
+{
+    const double phi[3] = {prevTemp, prevPower, 1.0};
+
+    double covPhi[3];
+    for (int i = 0; i < 3; i++) {
+        covPhi[i] = m_cov[i][0] * phi[0] + m_cov[i][1] * phi[1] + m_cov[i][2] * phi[2];
+    }
+
+    const double denom = FORGETTING + phi[0] * covPhi[0] + phi[1] * covPhi[1] + phi[2] * covPhi[2];
+    if (denom <= 0.0 || !qIsFinite(denom)) {
+        reset();
+        return;
+    }
+
+    const double residual = temp - (m_theta[0] * phi[0] + m_theta[1] * phi[1] + m_theta[2] * phi[2]);
+
+    double gain[3];
+    for (int i = 0; i < 3; i++) {
+        gain[i] = covPhi[i] / denom;
+        m_theta[i] += gain[i] * residual;
+    }
+
+    double trace = 0.0;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            m_cov[i][j] = (m_cov[i][j] - gain[i] * covPhi[j]) / FORGETTING;
+        }
+        trace += m_cov[i][i];
+    }
+
+    // With constant input the forgetting factor inflates the covariance
+    // without bound; cap it so a sudden load change does not blow up the fit
+    if (trace > INITIAL_COVARIANCE * 3) {
+        const double scale = INITIAL_COVARIANCE * 3 / trace;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                m_cov[i][j] *= scale;
+            }
+        }
+    }
+}
+
+double ThermalModel::predict(int steps) const
+{
+    const double a = m_theta[0];
+    const double b = m_theta[1];
+    const double c = m_theta[2];
+
+    // An unstable or non-physical fit is worse than no prediction
+    if (a < 0.0 || a >= 1.0 || !qIsFinite(b) || !qIsFinite(c)) {
+        return m_lastTemp;
+    }
+
+    double temp = m_lastTemp;
+    for (int i = 0; i < steps; i++) {
+        temp = a * temp + b * m_lastPower + c;
+    }
+
+    if (!qIsFinite(temp)) {
+        return m_lastTemp;
+    }
+    return qBound(0.0, temp, 150.0);
+}
@@ -0,0 +1,66 @@
+#ifndef THERMALMODEL_H
+#define THERMALMODEL_H
+
+#include <QtGlobal>
+
+// Lumped RC thermal model fitted online with recursive least squares.
+//
+// The package is treated as a single thermal mass heated by the measured
+// power, discretised at the sampling interval:
+//
+//     T[k+1] = a * T[k] + b * P[k] + c
+//
+// a captures the RC time constant, b the thermal resistance and c the
+// ambient term. Parameters are refitted on every sample, so the model
+// follows changes in ambient temperature and fan behaviour.
+class ThermalModel
+{
+public:
+    ThermalModel();
+
+    // Feed one sample (degrees C, watts). Cheap enough to run every tick.
+    void addSample(double temperature, double power);
+
+    // Temperature expected after `steps` samples if power stays constant.
+    double predict(int steps) const;
+
+    // Clamped to 1..maxHorizon(), the samples the history ring can score
+    void setHorizon(int steps);
+    int horizon() const { return m_horizon; }
+    static constexpr int maxHorizon() { return MAX_HORIZON - 1; }
+
+    bool isReady() const { return m_samples >= WARMUP_SAMPLES; }
+    double predictedTemperature() const { return m_predicted; }
+    // Absolute error between past predictions and what was then measured,
+    // as an exponential moving average (weight ERROR_SMOOTHING per sample)
+    double predictionError() const { return m_error; }
+
+    void reset();
+
+private:
+    void updateFit(double prevTemp, double prevPower, double temp);
+
+    double m_theta[3];
+    double m_cov[3][3];
+
+    double m_lastTemp = 0.0;
+    double m_lastPower = 0.0;
+    int m_samples = 0;
+
+    int m_horizon = 5;
+    double m_predicted = 0.0;
+    double m_error = 0.0;
+
+    // Ring of past predictions, indexed by sample number, to score them
+    // once the horizon has elapsed
+    static constexpr int MAX_HORIZON = 32;
+    double m_history[MAX_HORIZON];
+    bool m_historyValid[MAX_HORIZON];
+
+    static constexpr double FORGETTING = 0.98;
+    static constexpr double INITIAL_COVARIANCE = 1000.0;
+    static constexpr double ERROR_SMOOTHING = 0.1;
+    static constexpr int WARMUP_SAMPLES = 10;
+};
+
+#endif // THERMALMODEL_H
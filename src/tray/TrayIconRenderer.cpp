@@ -0,0 +1,108 @@
+#include "TrayIconRenderer.h"
+#include <QFont>
+#include <QFontMetrics>
+#include <QPainter>
+#include <cstring>
+
+TrayIconRenderer::TrayIconRenderer(int size)
+    : m_size(size)
+    , m_image(size, size, QImage::Format_ARGB32_Premultiplied)
+{
+    m_image.fill(Qt::transparent);
+    buildAtlas();
+}
+
+void TrayIconRenderer::buildAtlas()
+{
+    const QString glyphs[GLYPH_COUNT] = {
+        "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", QString(QChar(0x00B0)), "W"
+    };
+
+    // Largest bold font that still fits three digits across the icon
+    QFont font;
+    font.setStyleHint(QFont::SansSerif);
+    font.setBold(true);
+    int pixelSize = m_size * 3 / 4;
+    font.setPixelSize(pixelSize);
+    while (pixelSize > 6 && QFontMetrics(font).horizontalAdvance("888") > m_size) {
+        font.setPixelSize(--pixelSize);
+    }
+
+    const QFontMetrics metrics(font);
+    int width = 0;
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        m_glyphs[i] = {width, metrics.horizontalAdvance(glyphs[i])};
+        width += m_glyphs[i].width;
+    }
+
+    m_atlas = QImage(width, metrics.height(), QImage::Format_ARGB32_Premultiplied);
+    m_atlas.fill(Qt::transparent);
+    QPainter painter(&m_atlas);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    painter.setFont(font);
+    painter.setPen(Qt::white);
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        painter.drawText(m_glyphs[i].x, metrics.ascent(), glyphs[i]);
+    }
+    painter.end();
+
+    // Crop to the ink of the digits so the text centres optically
+    const QRect ink = metrics.tightBoundingRect("0123456789W");
+    m_glyphTop = qMax(0, metrics.ascent() + ink.top());
+    m_glyphHeight = qMin(ink.height(), m_atlas.height() - m_glyphTop);
+
+    m_tintColor = 0;
+}
+
+void TrayIconRenderer::tint(QRgb color)
+{
+    m_tinted = m_atlas.copy();
+    QPainter painter(&m_tinted);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+    painter.fillRect(m_tinted.rect(), QColor::fromRgb(color));
+    m_tintColor = color;
+}
+
+bool TrayIconRenderer::render(int value, Unit unit, QRgb color)
+{
+    value = qBound(0, value, 999);
+
+    int text[MAX_GLYPHS];
+    int length = 0;
+    if (value >= 100) text[length++] = value / 100;
+    if (value >= 10) text[length++] = value / 10 % 10;
+    text[length++] = value % 10;
+    text[length++] = unit == Celsius ? GLYPH_DEGREE : GLYPH_WATT;
+
+    int width = 0;
+    for (int i = 0; i < length; i++) {
+        width += m_glyphs[text[i]].width;
+    }
+    // Three digits leave no room for the unit
+    if (width > m_size) {
+        width -= m_glyphs[text[--length]].width;
+    }
+
+    if (length == m_length && color == m_color
+        && std::memcmp(text, m_text, length * sizeof(int)) == 0) {
+        return false;
+    }
+    std::memcpy(m_text, text, length * sizeof(int));
+    m_length = length;
+    m_color = color;
+
+    if (m_tinted.isNull() || color != m_tintColor) {
+        tint(color);
+    }
+
+    m_image.fill(Qt::transparent);
+    QPainter painter(&m_image);
+    int x = (m_size - width) / 2;
+    const int y = (m_size - m_glyphHeight) / 2;
+    for (int i = 0; i < length; i++) {
+        const Glyph &glyph = m_glyphs[text[i]];
+        painter.drawImage(QPoint(x, y), m_tinted, QRect(glyph.x, m_glyphTop, glyph.width, m_glyphHeight));
+        x += glyph.width;
+    }
+    return true;
+}
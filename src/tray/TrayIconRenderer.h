@@ -0,0 +1,56 @@
+#ifndef TRAYICONRENDERER_H
+#define TRAYICONRENDERER_H
+
+#include <QImage>
+#include <QRgb>
+
+// Draws a short reading ("72°", "45W") into the tray icon.
+//
+// The digits, degree sign and "W" are rasterised once into a glyph atlas
+// and tinted once per colour; an update is a fill and a few blits into the
+// same QImage. render() only repaints when the text or colour differs from
+// the previous call, so the caller can skip setIcon() when nothing changed.
+class TrayIconRenderer
+{
+public:
+    enum Unit {
+        Celsius,
+        Watts
+    };
+
+    explicit TrayIconRenderer(int size = 32);
+
+    // True if the image was repainted
+    bool render(int value, Unit unit, QRgb color);
+    const QImage &image() const { return m_image; }
+
+private:
+    // Atlas order: 0-9, degree sign, W
+    static constexpr int GLYPH_COUNT = 12;
+    static constexpr int GLYPH_DEGREE = 10;
+    static constexpr int GLYPH_WATT = 11;
+    static constexpr int MAX_GLYPHS = 4;
+
+    struct Glyph {
+        int x;
+        int width;
+    };
+
+    void buildAtlas();
+    void tint(QRgb color);
+
+    int m_size;
+    QImage m_atlas;           // White glyphs on transparent
+    QImage m_tinted;          // m_atlas in m_tintColor
+    QRgb m_tintColor = 0;
+    Glyph m_glyphs[GLYPH_COUNT] = {};
+    int m_glyphTop = 0;       // Rows of the atlas the glyphs actually cover
+    int m_glyphHeight = 0;
+
+    QImage m_image;
+    int m_text[MAX_GLYPHS] = {};
+    int m_length = 0;
+    QRgb m_color = 0;
+};
+
+#endif // TRAYICONRENDERER_H
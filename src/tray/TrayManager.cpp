@@ -1,25 +1,47 @@
 #include "TrayManager.h"
 #include "PerformanceController.h"
 #include "GpuController.h"
+#include "SystemMonitor.h"
+#include "TraySensorRows.h"
+#include "Trace.h"
 #include <QGuiApplication>
 #include <QIcon>
+#include <QPixmap>
+
+namespace {
+
+QRgb profileColor(int profile)
+{
+    switch (profile) {
+        case 0: return qRgb(0x4f, 0xc3, 0xf7); // Silent
+        case 2: return qRgb(0xff, 0x8a, 0x65); // Turbo
+        default: return qRgb(0x81, 0xc7, 0x84); // Balanced
+    }
+}
+
+} // namespace
 
 TrayManager::TrayManager(PerformanceController *perfController,
                         GpuController *gpuController,
+                        SystemMonitor *monitor,
                         QObject *parent)
     : QObject(parent)
     , m_trayIcon(new QSystemTrayIcon(this))
     , m_menu(new QMenu())
     , m_perfController(perfController)
     , m_gpuController(gpuController)
+    , m_monitor(monitor)
 {
     createMenu();
+    createSensorRows();
     createTrayIcon();
 
     connect(m_perfController, &PerformanceController::currentProfileChanged,
             this, &TrayManager::onPerformanceProfileChanged);
     connect(m_gpuController, &GpuController::currentModeChanged,
             this, &TrayManager::onGpuModeChanged);
+    connect(m_monitor, &SystemMonitor::sampled,
+            this, &TrayManager::onSampled);
 
     updateIcon();
     updateTooltip();
@@ -43,6 +65,14 @@ void TrayManager::setVisible(bool visible)
     }
 }
 
+void TrayManager::setIconContent(int content)
+{
+    if (m_iconContent == content) return;
+    m_iconContent = content;
+    updateIcon();
+    updateTooltip();
+}
+
 void TrayManager::showMessage(const QString &title, const QString &message, int icon, int msecs)
 {
     QSystemTrayIcon::MessageIcon msgIcon = static_cast<QSystemTrayIcon::MessageIcon>(icon);
@@ -53,6 +83,7 @@ void TrayManager::createTrayIcon()
 {
     m_trayIcon->setContextMenu(m_menu);
     m_trayIcon->setIcon(QIcon(":/icons/g-helper.svg"));
+    m_showingLogo = true;
 
     connect(m_trayIcon, &QSystemTrayIcon::activated,
             this, &TrayManager::onActivated);
@@ -96,7 +127,7 @@ void TrayManager::createMenu()
 
     // Show window action
     m_showAction = m_menu->addAction(tr("Show G-Helper"));
-    connect(m_showAction, &QAction::triggered, this, &TrayManager::showWindowRequested);
+    connect(m_showAction, &QAction::triggered, this, &TrayManager::requestShow);
 
     // Quit action
     m_quitAction = m_menu->addAction(tr("Quit"));
@@ -107,10 +138,67 @@ void TrayManager::createMenu()
     onGpuModeChanged(m_gpuController->currentMode());
 }
 
+void TrayManager::createSensorRows()
+{
+    // Above the profile and GPU submenus; refreshed only while the menu is open
+    QAction *first = m_perfMenu->menuAction();
+    m_sensorRows = new TraySensorRows(m_menu, first, m_monitor, this);
+
+    m_sensorRows->addRow([this]() {
+        const int temp = m_monitor->cpuTemp();
+        return temp > 0 ? tr("CPU: %1°C, %2%").arg(temp).arg(qRound(m_monitor->cpuUsage())) : QString();
+    });
+    m_sensorRows->addRow([this]() {
+        const int temp = m_monitor->dgpuTemp() > 0 ? m_monitor->dgpuTemp() : m_monitor->gpuTemp();
+        return temp > 0 ? tr("GPU: %1°C").arg(temp) : QString();
+    });
+    m_sensorRows->addRow([this]() {
+        QStringList rpms;
+        for (int rpm : m_monitor->fanRpms()) {
+            rpms << QString::number(rpm);
+        }
+        return rpms.isEmpty() ? QString() : tr("Fans: %1 RPM").arg(rpms.join(" / "));
+    });
+    m_sensorRows->addRow([this]() {
+        const double power = m_monitor->systemPower();
+        return power > 0.1 ? tr("Power: %1 W").arg(power, 0, 'f', 1) : QString();
+    });
+
+    m_menu->insertSeparator(first);
+}
+
+void TrayManager::addSensorRow(std::function<QString()> value)
+{
+    m_sensorRows->addRow(std::move(value));
+}
+
 void TrayManager::updateIcon()
 {
-    // Could change icon based on current profile
-    m_trayIcon->setIcon(QIcon(":/icons/g-helper.svg"));
+    TRACE_SPAN("Tray icon update", "tray");
+
+    // Nothing to show yet (no sensor, first sample pending): keep the logo
+    int value = 0;
+    if (m_iconContent == CpuTemperature) {
+        value = m_monitor->cpuTemp();
+    } else if (m_iconContent == PowerDraw) {
+        value = qRound(m_monitor->systemPower());
+    }
+    if (value <= 0) {
+        if (!m_showingLogo) {
+            m_trayIcon->setIcon(QIcon(":/icons/g-helper.svg"));
+            m_showingLogo = true;
+        }
+        return;
+    }
+
+    const auto unit = m_iconContent == CpuTemperature ? TrayIconRenderer::Celsius
+                                                      : TrayIconRenderer::Watts;
+    // setIcon() goes out to the tray host; only when the picture changed
+    if (m_iconRenderer.render(value, unit, profileColor(m_perfController->currentProfile()))
+        || m_showingLogo) {
+        m_trayIcon->setIcon(QIcon(QPixmap::fromImage(m_iconRenderer.image())));
+        m_showingLogo = false;
+    }
 }
 
 void TrayManager::updateTooltip()
@@ -118,14 +206,29 @@ void TrayManager::updateTooltip()
     QString tooltip = QString("G-Helper Linux\n%1 | %2")
         .arg(m_perfController->currentProfileName())
         .arg(m_gpuController->currentModeName());
-    m_trayIcon->setToolTip(tooltip);
+    if (m_iconContent != Logo && m_monitor->cpuTemp() > 0) {
+        tooltip += QString("\nCPU %1°C | %2 W")
+            .arg(m_monitor->cpuTemp())
+            .arg(qRound(m_monitor->systemPower()));
+    }
+    if (tooltip != m_tooltip) {
+        m_tooltip = tooltip;
+        m_trayIcon->setToolTip(tooltip);
+    }
+}
+
+void TrayManager::requestShow()
+{
+    QElapsedTimer since;
+    since.start();
+    emit showWindowRequested(since);
 }
 
 void TrayManager::onActivated(QSystemTrayIcon::ActivationReason reason)
 {
     if (reason == QSystemTrayIcon::DoubleClick ||
         reason == QSystemTrayIcon::Trigger) {
-        emit showWindowRequested();
+        requestShow();
     }
 }
 
@@ -134,6 +237,7 @@ void TrayManager::onPerformanceProfileChanged(int profile)
     m_quietAction->setChecked(profile == 0);
     m_balancedAction->setChecked(profile == 1);
     m_performanceAction->setChecked(profile == 2);
+    updateIcon();
     updateTooltip();
 }
 
@@ -145,6 +249,13 @@ void TrayManager::onGpuModeChanged(int mode)
     updateTooltip();
 }
 
+void TrayManager::onSampled()
+{
+    if (m_iconContent == Logo) return;
+    updateIcon();
+    updateTooltip();
+}
+
 void TrayManager::setQuietProfile()
 {
     m_perfController->setProfile(0);
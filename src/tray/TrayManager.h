@@ -2,12 +2,17 @@
 #define TRAYMANAGER_H
 
 #include <QObject>
+#include <QElapsedTimer>
 #include <QSystemTrayIcon>
 #include <QMenu>
 #include <QAction>
+#include <functional>
+#include "TrayIconRenderer.h"
 
 class PerformanceController;
 class GpuController;
+class SystemMonitor;
+class TraySensorRows;
 
 class TrayManager : public QObject
 {
@@ -15,26 +20,46 @@ class TrayManager : public QObject
     Q_PROPERTY(bool visible READ isVisible WRITE setVisible NOTIFY visibleChanged)
 
 public:
+    enum IconContent {
+        Logo = 0,
+        CpuTemperature = 1,
+        PowerDraw = 2
+    };
+    Q_ENUM(IconContent)
+
     explicit TrayManager(PerformanceController *perfController,
                         GpuController *gpuController,
+                        SystemMonitor *monitor,
                         QObject *parent = nullptr);
     ~TrayManager() override;
 
     bool isVisible() const;
     void setVisible(bool visible);
 
+    // Logo, or a live reading drawn in the profile colour
+    void setIconContent(int content);
+
+    // Extra live row at the end of the sensor rows (hidden while value is empty)
+    void addSensorRow(std::function<QString()> value);
+
     Q_INVOKABLE void showMessage(const QString &title, const QString &message,
                                  int icon = 0, int msecs = 5000);
 
+    // What a click on the icon or the Show action does
+    void requestShow();
+
 signals:
     void visibleChanged(bool visible);
-    void showWindowRequested();
+    // since was started by the click itself, so show latency includes
+    // everything from here to the first frame
+    void showWindowRequested(const QElapsedTimer &since);
     void quitRequested();
 
 private slots:
     void onActivated(QSystemTrayIcon::ActivationReason reason);
     void onPerformanceProfileChanged(int profile);
     void onGpuModeChanged(int mode);
+    void onSampled();
 
     // Performance profile actions
     void setQuietProfile();
@@ -49,11 +74,13 @@ private slots:
 private:
     void createTrayIcon();
     void createMenu();
+    void createSensorRows();
     void updateIcon();
     void updateTooltip();
 
     QSystemTrayIcon *m_trayIcon;
     QMenu *m_menu;
+    TraySensorRows *m_sensorRows = nullptr;
 
     // Performance submenu
     QMenu *m_perfMenu;
@@ -73,6 +100,12 @@ private:
 
     PerformanceController *m_perfController;
     GpuController *m_gpuController;
+    SystemMonitor *m_monitor;
+
+    TrayIconRenderer m_iconRenderer;
+    int m_iconContent = Logo;
+    bool m_showingLogo = false;
+    QString m_tooltip;
 };
 
 #endif // TRAYMANAGER_H
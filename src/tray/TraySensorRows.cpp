@@ -0,0 +1,60 @@
+#include "TraySensorRows.h"
+#include "SystemMonitor.h"
+#include "Trace.h"
+#include <QAction>
+#include <QMenu>
+
+TraySensorRows::TraySensorRows(QMenu *menu, QAction *before, SystemMonitor *monitor,
+                               QObject *parent)
+    : QObject(parent)
+    , m_menu(menu)
+    , m_before(before)
+    , m_monitor(monitor)
+{
+    connect(m_menu, &QMenu::aboutToShow, this, &TraySensorRows::onAboutToShow);
+    connect(m_menu, &QMenu::aboutToHide, this, &TraySensorRows::onAboutToHide);
+}
+
+TraySensorRows::~TraySensorRows() = default;
+
+void TraySensorRows::addRow(Value value)
+{
+    auto *action = new QAction(m_menu);
+    action->setEnabled(false);
+    action->setVisible(false);
+    m_menu->insertAction(m_before, action);
+    m_rows.append({action, std::move(value), QString()});
+}
+
+void TraySensorRows::onAboutToShow()
+{
+    refresh();
+    if (!m_sampled) {
+        m_sampled = connect(m_monitor, &SystemMonitor::sampled, this, &TraySensorRows::refresh);
+    }
+}
+
+void TraySensorRows::onAboutToHide()
+{
+    disconnect(m_sampled);
+    m_sampled = {};
+}
+
+void TraySensorRows::refresh()
+{
+    TRACE_SPAN("Tray menu rows", "tray");
+
+    for (Row &row : m_rows) {
+        const QString text = row.value();
+        if (text == row.text) continue;
+
+        // Visibility changes relayout the menu; only flip it at the edges
+        if (text.isEmpty() != row.text.isEmpty()) {
+            row.action->setVisible(!text.isEmpty());
+        }
+        if (!text.isEmpty()) {
+            row.action->setText(text);
+        }
+        row.text = text;
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef TRAYSENSORROWS_H
+#define TRAYSENSORROWS_H
+
+#include <QObject>
+#include <QList>
+#include <QMetaObject>
+#include <functional>
+
+class QAction;
+class QMenu;
+class SystemMonitor;
+
+// Read-only menu rows that follow SystemMonitor while the menu is open.
+//
+// Each row is a disabled QAction whose text comes from a value function.
+// Rows are refreshed when the menu is about to show and on every sample
+// while it stays open; only rows whose text changed are touched, so the
+// tray host (StatusNotifierItem's D-Bus menu) is sent just those items.
+// While the menu is closed nothing is connected and nothing runs. A row
+// whose value is empty is hidden.
+class TraySensorRows : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Value = std::function<QString()>;
+
+    // Rows are inserted into menu before the action "before" (appended if null)
+    TraySensorRows(QMenu *menu, QAction *before, SystemMonitor *monitor,
+                   QObject *parent = nullptr);
+    ~TraySensorRows() override;
+
+    void addRow(Value value);
+    bool isOpen() const { return static_cast<bool>(m_sampled); }
+
+private:
+    void onAboutToShow();
+    void onAboutToHide();
+    void refresh();
+
+    struct Row {
+        QAction *action;
+        Value value;
+        QString text;
+    };
+
+    QMenu *m_menu;
+    QAction *m_before;
+    SystemMonitor *m_monitor;
+    QList<Row> m_rows;
+    QMetaObject::Connection m_sampled;
+};
+
+#endif // TRAYSENSORROWS_H
@@ -0,0 +1,220 @@
+#include "WindowHost.h"
+#include "Trace.h"
+#include <QDebug>
+#include <QFile>
+#include <QGuiApplication>
+#include <QQmlApplicationEngine>
+#include <QQuickWindow>
+#include <QScreen>
+#include <QTimer>
+#include <ctime>
+#include <memory>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace {
+
+qint64 residentKb()
+{
+    // Second field of statm: resident pages
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) return -1;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2) return -1;
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE) / 1024;
+}
+
+qint64 cpuTimeMs()
+{
+    return static_cast<qint64>(std::clock()) * 1000 / CLOCKS_PER_SEC;
+}
+
+} // namespace
+
+WindowHost::WindowHost(const QUrl &url, QObject *parent)
+    : QObject(parent)
+    , m_url(url)
+    , m_unloadTimer(new QTimer(this))
+{
+    m_unloadTimer->setSingleShot(true);
+    connect(m_unloadTimer, &QTimer::timeout, this, &WindowHost::unload);
+
+    m_stateTimer.start();
+    m_stateCpuStartMs = cpuTimeMs();
+}
+
+WindowHost::~WindowHost()
+{
+    delete m_engine;
+}
+
+bool WindowHost::isVisible() const
+{
+    return m_window && m_window->isVisible();
+}
+
+void WindowHost::setUnloadDelay(int seconds)
+{
+    m_unloadDelay = qMax(0, seconds);
+    if (m_unloadDelay == 0) {
+        m_unloadTimer->stop();
+    } else if (m_window && !m_window->isVisible()) {
+        m_unloadTimer->start(m_unloadDelay * 1000);
+    }
+}
+
+void WindowHost::show()
+{
+    showSince(QElapsedTimer());
+}
+
+void WindowHost::showSince(const QElapsedTimer &since)
+{
+    m_unloadTimer->stop();
+    if (m_window && m_window->isVisible()) {
+        m_window->raise();
+        m_window->requestActivate();
+        return;
+    }
+
+    if (since.isValid()) {
+        m_showTimer = since;
+    } else {
+        m_showTimer.start();
+    }
+    const bool cold = !m_engine;
+    emit aboutToShow();
+    if (cold && !load()) return;
+
+    timeFirstFrame(cold);
+    positionWindow();
+    m_window->show();
+    m_window->raise();
+    m_window->requestActivate();
+}
+
+void WindowHost::hide()
+{
+    if (m_window) m_window->hide();
+}
+
+void WindowHost::timeFirstFrame(bool cold)
+{
+    const qint64 start = Trace::now() - m_showTimer.nsecsElapsed();
+    // frameSwapped comes from the render thread; this queues back to ours
+    auto firstFrame = std::make_shared<QMetaObject::Connection>();
+    *firstFrame = connect(m_window, &QQuickWindow::frameSwapped, this, [this, firstFrame, cold, start]() {
+        disconnect(*firstFrame);
+        const qint64 msecs = m_showTimer.elapsed();
+        Trace::complete(cold ? "Show to first frame (cold)" : "Show to first frame", "ui", start, Trace::now());
+        qInfo().noquote() << QString("WindowHost: show -> first frame in %1 ms (%2)")
+            .arg(msecs).arg(cold ? "cold" : "warm");
+        emit shown(msecs, cold);
+    });
+}
+
+bool WindowHost::load()
+{
+    TRACE_SPAN("Main.qml load", "qml");
+
+    m_engine = new QQmlApplicationEngine(this);
+    m_engine->addImportPath("qrc:/");
+    connect(m_engine, &QQmlApplicationEngine::objectCreated, this, [](QObject *object) {
+        if (object) Trace::instant("QML root object created", "qml");
+    });
+
+    m_engine->load(m_url);
+
+    QObject *root = m_engine->rootObjects().isEmpty() ? nullptr : m_engine->rootObjects().first();
+    m_window = qobject_cast<QQuickWindow*>(root);
+    if (!m_window) {
+        qWarning() << "WindowHost: Failed to create the main window from" << m_url;
+        delete m_engine;
+        m_engine = nullptr;
+        emit loadFailed();
+        return false;
+    }
+
+    // Keep the scene graph and graphics resources across hide/show so a
+    // warm show only has to render, not rebuild
+    m_window->setPersistentSceneGraph(true);
+    m_window->setPersistentGraphics(true);
+
+    connect(m_window, &QWindow::visibleChanged, this, &WindowHost::onWindowVisibleChanged);
+
+    emit loadedChanged(true);
+    emit windowCreated(m_window);
+    if (m_window->isVisible()) {
+        onWindowVisibleChanged(true);
+    }
+    return true;
+}
+
+void WindowHost::unload()
+{
+    if (!m_engine) return;
+    m_unloadTimer->stop();
+
+    if (m_window && m_window->isVisible()) {
+        emit visibleChanged(false);
+    }
+
+    // The window is a root object of the engine and goes with it
+    m_window.clear();
+    m_engine->deleteLater();
+    m_engine = nullptr;
+    emit loadedChanged(false);
+
+    // Measure once the engine is actually gone
+    QTimer::singleShot(0, this, [this]() {
+#ifdef __GLIBC__
+        // Hand the freed QML heap back to the system so RSS reflects it
+        malloc_trim(0);
+#endif
+        logResourceUsage("unloaded");
+    });
+}
+
+void WindowHost::onWindowVisibleChanged(bool visible)
+{
+    logResourceUsage(visible ? "visible" : "hidden");
+
+    if (visible) {
+        m_unloadTimer->stop();
+    } else if (m_unloadDelay > 0) {
+        m_unloadTimer->start(m_unloadDelay * 1000);
+    }
+    emit visibleChanged(visible);
+}
+
+void WindowHost::positionWindow()
+{
+    // Bottom right, next to where the tray usually is
+    QScreen *screen = QGuiApplication::primaryScreen();
+    if (!m_window || !screen) return;
+
+    QRect availableGeometry = screen->availableGeometry();
+    int x = availableGeometry.right() - m_window->width() - 12;
+    int y = availableGeometry.bottom() - m_window->height() - 60;
+    m_window->setPosition(x, y);
+}
+
+void WindowHost::logResourceUsage(const char *entering)
+{
+    if (qstrcmp(m_state, entering) == 0) return;
+
+    const qint64 wallMs = m_stateTimer.restart();
+    const qint64 cpuMs = cpuTimeMs();
+    const double cpuShare = wallMs > 0 ? 100.0 * (cpuMs - m_stateCpuStartMs) / wallMs : 0.0;
+
+    qInfo().noquote() << QString("WindowHost: %1 -> %2, RSS %3 MB; CPU %4% over %5 s while %1")
+        .arg(QString::fromLatin1(m_state), QString::fromLatin1(entering))
+        .arg(residentKb() / 1024.0, 0, 'f', 1)
+        .arg(cpuShare, 0, 'f', 2)
+        .arg(wallMs / 1000.0, 0, 'f', 1);
+
+    m_state = entering;
+    m_stateCpuStartMs = cpuMs;
+}
@@ -0,0 +1,80 @@
+#ifndef WINDOWHOST_H
+#define WINDOWHOST_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QUrl>
+
+class QQmlApplicationEngine;
+class QQuickWindow;
+class QTimer;
+
+// Owns the QML engine behind the main window for a tray-resident app.
+//
+// The engine and its window are created on show() and destroyed once the
+// window has been hidden for unloadDelay seconds, dropping every panel,
+// binding and the scene graph. Controllers live outside the engine and are
+// unaffected. Resident memory and CPU time are logged on each transition so
+// the hidden and visible costs can be compared.
+//
+// A window that is still loaded keeps its scene graph and graphics resources
+// while hidden. Showing it emits aboutToShow() first, so pending state can be
+// applied in one batch before the first frame. Each show is timed to the
+// first frame presented (shown()), from the user's request when that is
+// known (showSince()).
+class WindowHost : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool loaded READ isLoaded NOTIFY loadedChanged)
+
+public:
+    explicit WindowHost(const QUrl &url, QObject *parent = nullptr);
+    ~WindowHost() override;
+
+    bool isLoaded() const { return m_engine != nullptr; }
+    bool isVisible() const;
+    QQuickWindow *window() const { return m_window; }
+
+    // 0 keeps the UI loaded while hidden
+    void setUnloadDelay(int seconds);
+
+public slots:
+    // Creates the UI if it is not loaded, then shows and raises it
+    void show();
+    // As show(), timed from since (e.g. the tray click) instead of now
+    void showSince(const QElapsedTimer &since);
+    void hide();
+    void unload();
+
+signals:
+    void windowCreated(QQuickWindow *window);
+    // Before the window becomes visible; receivers run before its first frame
+    void aboutToShow();
+    // Request to first frame presented; cold when the UI had to be loaded
+    void shown(qint64 msecs, bool cold);
+    void visibleChanged(bool visible);
+    void loadedChanged(bool loaded);
+    void loadFailed();
+
+private:
+    bool load();
+    void onWindowVisibleChanged(bool visible);
+    void positionWindow();
+    void timeFirstFrame(bool cold);
+    // Logs RSS and the CPU share spent since the previous transition
+    void logResourceUsage(const char *entering);
+
+    QUrl m_url;
+    QQmlApplicationEngine *m_engine = nullptr;
+    QPointer<QQuickWindow> m_window;
+    QTimer *m_unloadTimer;
+    int m_unloadDelay = 60; // seconds
+    QElapsedTimer m_showTimer;
+
+    const char *m_state = "starting";
+    QElapsedTimer m_stateTimer;
+    qint64 m_stateCpuStartMs = 0;
+};
+
+#endif // WINDOWHOST_H
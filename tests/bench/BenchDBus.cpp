@@ -0,0 +1,247 @@
+#include "TestSuite.h"
+#include "PrivateBus.h"
+#include "MockAsusd.h"
+#include "MockSuperGfx.h"
+#include "FanCurveFixtures.h"
+#include "AsusdClient.h"
+#include "SuperGfxClient.h"
+#include "SystemBus.h"
+#include "LatencyStats.h"
+#include <QSignalSpy>
+#include <QTest>
+#include <memory>
+
+// Client round trips against the mock daemons: one iteration is the call
+// plus its reply handler, the point LatencyStats records. The mocks answer
+// at once, so this is our own marshalling and dispatch plus the bus hop.
+class BenchDBus : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void nameHasOwner();
+    void platformGetAll();
+    void setPlatformProfile();
+    void setChargeLimit();
+    void setLedBrightness();
+    void setLedMode();
+    void setFanCurve();
+    void readFanCurves();
+    void resetFanCurves();
+    void gfxMode();
+    void gfxPower();
+    void gfxSetMode();
+    void writeThroughput_data();
+    void writeThroughput();
+
+private:
+    // Spins the event loop until op has been recorded count times in total
+    static bool waitFor(LatencyStats::Operation op, qint64 count);
+
+    std::unique_ptr<MockAsusd> m_asusd;
+    std::unique_ptr<MockSuperGfx> m_gfx;
+    std::unique_ptr<AsusdClient> m_client;
+    std::unique_ptr<SuperGfxClient> m_gfxClient;
+};
+
+bool BenchDBus::waitFor(LatencyStats::Operation op, qint64 count)
+{
+    return QTest::qWaitFor([op, count]() { return LatencyStats::instance()->count(op) >= count; }, 5000);
+}
+
+void BenchDBus::initTestCase()
+{
+    if (!PrivateBus::isRunning()) {
+        QSKIP("dbus-daemon is not available");
+    }
+    m_asusd = std::make_unique<MockAsusd>();
+    m_gfx = std::make_unique<MockSuperGfx>();
+    QVERIFY(m_asusd->start());
+    QVERIFY(m_gfx->start());
+
+    m_client = std::make_unique<AsusdClient>();
+    m_gfxClient = std::make_unique<SuperGfxClient>();
+    QTRY_VERIFY(m_client->isConnected());
+    QTRY_VERIFY(m_gfxClient->isConnected());
+    QTRY_VERIFY(!m_client->auraDevices().isEmpty());
+}
+
+void BenchDBus::cleanupTestCase()
+{
+    m_gfxClient.reset();
+    m_client.reset();
+    m_gfx.reset();
+    m_asusd.reset();
+}
+
+void BenchDBus::nameHasOwner()
+{
+    QBENCHMARK {
+        bool owned = false;
+        bool done = false;
+        SystemBus::probeService(m_asusd->service(), this, [&](bool hasOwner) {
+            owned = hasOwner;
+            done = true;
+        });
+        QVERIFY(QTest::qWaitFor([&done]() { return done; }, 5000));
+        QVERIFY(owned);
+    }
+}
+
+void BenchDBus::platformGetAll()
+{
+    auto *stats = LatencyStats::instance();
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::PropertiesGetAll);
+        m_client->refresh();
+        QVERIFY(waitFor(LatencyStats::PropertiesGetAll, count + 1));
+    }
+}
+
+void BenchDBus::setPlatformProfile()
+{
+    auto *stats = LatencyStats::instance();
+    quint32 profile = 0;
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::SetPlatformProfile);
+        m_client->setPlatformProfile(profile);
+        QVERIFY(waitFor(LatencyStats::SetPlatformProfile, count + 1));
+        profile = (profile + 1) % 3;
+    }
+    QCOMPARE(stats->errors(LatencyStats::SetPlatformProfile), qint64(0));
+}
+
+void BenchDBus::setChargeLimit()
+{
+    auto *stats = LatencyStats::instance();
+    quint8 limit = 60;
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::SetChargeLimit);
+        m_client->setChargeLimit(limit);
+        QVERIFY(waitFor(LatencyStats::SetChargeLimit, count + 1));
+        limit = limit == 60 ? 80 : 60;
+    }
+}
+
+void BenchDBus::setLedBrightness()
+{
+    auto *stats = LatencyStats::instance();
+    quint32 level = 0;
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::SetLedBrightness);
+        m_client->setLedBrightness(level);
+        QVERIFY(waitFor(LatencyStats::SetLedBrightness, count + 1));
+        level = (level + 1) % 4;
+    }
+}
+
+void BenchDBus::setLedMode()
+{
+    auto *stats = LatencyStats::instance();
+    quint8 red = 0;
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::SetLedMode);
+        m_client->setLedMode(0, {red, 0, 0});
+        QVERIFY(waitFor(LatencyStats::SetLedMode, count + 1));
+        red++;
+    }
+}
+
+void BenchDBus::setFanCurve()
+{
+    // One changed fan per iteration: the other two match the shadow copy
+    auto *stats = LatencyStats::instance();
+    int offset = 0;
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::SetFanCurve);
+        m_client->setFanCurves(0, {FanCurveFixtures::curve(0, 0, offset % 50)});
+        QVERIFY(waitFor(LatencyStats::SetFanCurve, count + 1));
+        offset++;
+    }
+}
+
+void BenchDBus::readFanCurves()
+{
+    QBENCHMARK {
+        bool done = false;
+        m_client->readFanCurves(1, [&done]() { done = true; });
+        QVERIFY(QTest::qWaitFor([&done]() { return done; }, 5000));
+    }
+}
+
+void BenchDBus::resetFanCurves()
+{
+    // ResetProfileCurves plus the FanCurveData read that follows it
+    QSignalSpy changed(m_client.get(), &AsusdClient::fanCurvesChanged);
+    QBENCHMARK {
+        const qsizetype count = changed.count();
+        m_client->resetFanCurves(2);
+        QVERIFY(QTest::qWaitFor([&]() { return changed.count() > count; }, 5000));
+    }
+}
+
+void BenchDBus::gfxMode()
+{
+    auto *stats = LatencyStats::instance();
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::GfxMode);
+        m_gfxClient->refresh();
+        QVERIFY(waitFor(LatencyStats::GfxMode, count + 1));
+    }
+}
+
+void BenchDBus::gfxPower()
+{
+    // NotifyGfxStatus -> Power: how fast a dGPU power change reaches us
+    auto *stats = LatencyStats::instance();
+    quint32 power = 0;
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::GfxPower);
+        m_gfx->setPower(power);
+        QVERIFY(waitFor(LatencyStats::GfxPower, count + 1));
+        power = power == 0 ? 2 : 0;
+    }
+}
+
+void BenchDBus::gfxSetMode()
+{
+    // Integrated <-> Hybrid switch without a logout
+    auto *stats = LatencyStats::instance();
+    int mode = SuperGfxClient::Integrated;
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::GfxSetMode);
+        m_gfxClient->setMode(mode);
+        QVERIFY(waitFor(LatencyStats::GfxSetMode, count + 1));
+        mode = mode == SuperGfxClient::Integrated ? SuperGfxClient::Hybrid : SuperGfxClient::Integrated;
+    }
+    QCOMPARE(stats->errors(LatencyStats::GfxSetMode), qint64(0));
+}
+
+void BenchDBus::writeThroughput_data()
+{
+    QTest::addColumn<int>("writes");
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+}
+
+void BenchDBus::writeThroughput()
+{
+    // A burst of writes in flight at once, as when a slider is dragged
+    QFETCH(int, writes);
+    auto *stats = LatencyStats::instance();
+    QBENCHMARK {
+        const qint64 count = stats->count(LatencyStats::SetChargeLimit);
+        for (int i = 0; i < writes; i++) {
+            m_client->setChargeLimit(static_cast<quint8>(60 + i % 40));
+        }
+        QVERIFY(waitFor(LatencyStats::SetChargeLimit, count + writes));
+    }
+    QCOMPARE(stats->errors(LatencyStats::SetChargeLimit), qint64(0));
+}
+
+GHELPER_TEST(BenchDBus);
+
+#include "BenchDBus.moc"
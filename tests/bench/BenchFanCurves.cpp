@@ -0,0 +1,82 @@
+#include "TestSuite.h"
+#include "FanCurveStore.h"
+#include "FanCurveFixtures.h"
+#include <QTemporaryDir>
+#include <QTest>
+
+// Fan curve persistence: the store is read at startup and written on edits
+class BenchFanCurves : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void load();
+    void setCurveUnchanged();
+    void flushOneChange();
+
+private:
+    void fill(FanCurveStore &store);
+
+    QTemporaryDir m_dir;
+};
+
+void BenchFanCurves::fill(FanCurveStore &store)
+{
+    for (int profile = 0; profile < FanCurveStore::PROFILE_COUNT; profile++) {
+        for (int fan = 0; fan < FanCurveStore::MAX_FANS; fan++) {
+            store.setCurve(profile, fan, FanCurveFixtures::points(profile * 5 + fan), true);
+        }
+    }
+}
+
+void BenchFanCurves::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+void BenchFanCurves::load()
+{
+    const QString path = m_dir.filePath("load.bin");
+    FanCurveStore writer(path);
+    fill(writer);
+    QVERIFY(writer.flush());
+
+    FanCurveStore store(path);
+    QBENCHMARK {
+        store.load();
+    }
+    QVERIFY(store.contains(2, 2));
+}
+
+void BenchFanCurves::setCurveUnchanged()
+{
+    // Dragging back to where a point was must not dirty the store
+    FanCurveStore store(m_dir.filePath("unchanged.bin"));
+    fill(store);
+    QVERIFY(store.flush());
+
+    const QVariantList points = FanCurveFixtures::points(0);
+    QBENCHMARK {
+        store.setCurve(0, 0, points, true);
+    }
+    QVERIFY(!store.isDirty());
+}
+
+void BenchFanCurves::flushOneChange()
+{
+    // An edit re-encodes one record and writes the file atomically
+    FanCurveStore store(m_dir.filePath("flush.bin"));
+    fill(store);
+    QVERIFY(store.flush());
+
+    int offset = 0;
+    QBENCHMARK {
+        store.setCurve(1, 0, FanCurveFixtures::points(offset++ % 40), true);
+        store.flush();
+    }
+}
+
+GHELPER_TEST(BenchFanCurves);
+
+#include "BenchFanCurves.moc"
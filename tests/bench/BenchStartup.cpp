@@ -0,0 +1,150 @@
+#include "TestSuite.h"
+#include "PrivateBus.h"
+#include "MockAsusd.h"
+#include "MockSuperGfx.h"
+#include <QProcess>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTest>
+#include <algorithm>
+#include <memory>
+
+// Time-to-tray and time-to-first-frame of the app itself, launched with
+// --startup-benchmark against the mock daemons. The "slow daemon" rows
+// hold every asusd/supergfxd reply back by SLOW_DAEMON_MS: neither
+// milestone may wait for them.
+class BenchStartup : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void timeToTray_data();
+    void timeToTray();
+    void timeToFirstFrame_data();
+    void timeToFirstFrame();
+
+private:
+    struct Launch {
+        qint64 trayMs = -1;
+        qint64 firstFrameMs = -1;
+    };
+
+    void addRows();
+    Launch launch();
+    // Median over RUNS launches of one milestone
+    qint64 median(qint64 Launch::*milestone);
+
+    static constexpr int RUNS = 5;
+    static constexpr int SLOW_DAEMON_MS = 2000;
+    static constexpr int LAUNCH_TIMEOUT_MS = 30000;
+
+    QTemporaryDir m_home;
+    std::unique_ptr<MockAsusd> m_asusd;
+    std::unique_ptr<MockSuperGfx> m_gfx;
+};
+
+void BenchStartup::initTestCase()
+{
+    if (!PrivateBus::isRunning()) {
+        QSKIP("dbus-daemon is not available");
+    }
+    QVERIFY(m_home.isValid());
+    m_asusd = std::make_unique<MockAsusd>();
+    m_gfx = std::make_unique<MockSuperGfx>();
+    QVERIFY(m_asusd->start());
+    QVERIFY(m_gfx->start());
+}
+
+void BenchStartup::cleanupTestCase()
+{
+    m_gfx.reset();
+    m_asusd.reset();
+}
+
+void BenchStartup::addRows()
+{
+    QTest::addColumn<int>("latency");
+    QTest::newRow("daemons") << 0;
+    QTest::newRow("slow daemons") << SLOW_DAEMON_MS;
+}
+
+BenchStartup::Launch BenchStartup::launch()
+{
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    // GHELPER_DBUS_ADDRESS is inherited; settings and the instance socket
+    // stay out of the user's session
+    env.insert("QT_QPA_PLATFORM", "offscreen");
+    env.insert("QT_QUICK_BACKEND", "software");
+    env.insert("XDG_CONFIG_HOME", m_home.filePath("config"));
+    env.insert("XDG_RUNTIME_DIR", m_home.path());
+
+    QProcess app;
+    app.setProcessEnvironment(env);
+    app.setProcessChannelMode(QProcess::SeparateChannels);
+    app.start(GHELPER_APP_PATH, {"--startup-benchmark"});
+
+    // Never waitForFinished(): the mocks answer from this event loop
+    Launch result;
+    if (!QTest::qWaitFor([&app]() { return app.state() == QProcess::NotRunning; }, LAUNCH_TIMEOUT_MS)) {
+        app.kill();
+        app.waitForFinished();
+        return result;
+    }
+
+    static const QRegularExpression line("Startup: (tray icon|first frame) after (\\d+) ms");
+    auto it = line.globalMatch(QString::fromUtf8(app.readAllStandardOutput()));
+    while (it.hasNext()) {
+        const QRegularExpressionMatch match = it.next();
+        (match.captured(1) == "tray icon" ? result.trayMs : result.firstFrameMs) = match.captured(2).toLongLong();
+    }
+    return result;
+}
+
+qint64 BenchStartup::median(qint64 Launch::*milestone)
+{
+    QFETCH(int, latency);
+    m_asusd->setLatency(latency);
+    m_gfx->setLatency(latency);
+
+    QList<qint64> times;
+    for (int i = 0; i < RUNS; i++) {
+        const Launch result = launch();
+        if (result.*milestone < 0) return -1;
+        times << result.*milestone;
+    }
+    std::sort(times.begin(), times.end());
+    return times.at(times.size() / 2);
+}
+
+void BenchStartup::timeToTray_data()
+{
+    addRows();
+}
+
+void BenchStartup::timeToTray()
+{
+    const qint64 msecs = median(&Launch::trayMs);
+    QVERIFY2(msecs >= 0, "The app did not report its tray icon");
+    QVERIFY2(msecs < SLOW_DAEMON_MS, "The tray icon waited for a daemon");
+    QTest::setBenchmarkResult(msecs, QTest::WalltimeMilliseconds);
+}
+
+void BenchStartup::timeToFirstFrame_data()
+{
+    addRows();
+}
+
+void BenchStartup::timeToFirstFrame()
+{
+    const qint64 msecs = median(&Launch::firstFrameMs);
+    QVERIFY2(msecs >= 0, "The app did not report its first frame");
+    QVERIFY2(msecs < SLOW_DAEMON_MS, "The first frame waited for a daemon");
+    QTest::setBenchmarkResult(msecs, QTest::WalltimeMilliseconds);
+}
+
+GHELPER_TEST(BenchStartup);
+
+#include "BenchStartup.moc"
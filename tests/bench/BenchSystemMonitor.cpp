@@ -0,0 +1,102 @@
+#include "TestSuite.h"
+#include "SystemMonitor.h"
+#include <QFile>
+#include <QTest>
+
+// One sampling tick and the procfs parsing inside it
+class BenchSystemMonitor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sample();
+    void sampleSuspended();
+    void parseCpuTimes();
+    void parseMemInfo();
+    void readProcStat();
+    void readProcMeminfo();
+
+private:
+    static QByteArray memInfoSample();
+};
+
+QByteArray BenchSystemMonitor::memInfoSample()
+{
+    // A full /proc/meminfo as found on a 32 GB laptop; MemAvailable is third
+    QByteArray data =
+        "MemTotal:       32594772 kB\n"
+        "MemFree:         1203948 kB\n"
+        "MemAvailable:   20421336 kB\n";
+    for (int i = 0; i < 50; i++) {
+        data += "Filler" + QByteArray::number(i) + ":       " + QByteArray::number(i * 1024) + " kB\n";
+    }
+    return data;
+}
+
+void BenchSystemMonitor::sample()
+{
+    SystemMonitor monitor;
+    QBENCHMARK {
+        QMetaObject::invokeMethod(&monitor, "update", Qt::DirectConnection);
+    }
+}
+
+void BenchSystemMonitor::sampleSuspended()
+{
+    // The tray-resident case: values update, NOTIFY signals are held back
+    SystemMonitor monitor;
+    monitor.setNotificationsSuspended(true);
+    QBENCHMARK {
+        QMetaObject::invokeMethod(&monitor, "update", Qt::DirectConnection);
+    }
+}
+
+void BenchSystemMonitor::parseCpuTimes()
+{
+    const QString line = QStringLiteral("cpu  4705356 150231 1120876 162500321 520042 0 45231 0 0 0");
+    qint64 total = 0;
+    qint64 idle = 0;
+    QBENCHMARK {
+        SystemMonitor::parseCpuTimes(line, &total, &idle);
+    }
+    QVERIFY(total > 0);
+}
+
+void BenchSystemMonitor::parseMemInfo()
+{
+    const QByteArray data = memInfoSample();
+    qint64 total = 0;
+    qint64 available = 0;
+    QBENCHMARK {
+        SystemMonitor::parseMemInfo(data, &total, &available);
+    }
+    QVERIFY(total > 0);
+}
+
+void BenchSystemMonitor::readProcStat()
+{
+    qint64 total = 0;
+    qint64 idle = 0;
+    QBENCHMARK {
+        QFile file("/proc/stat");
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            SystemMonitor::parseCpuTimes(QString::fromLatin1(file.readLine().trimmed()), &total, &idle);
+        }
+    }
+}
+
+void BenchSystemMonitor::readProcMeminfo()
+{
+    qint64 total = 0;
+    qint64 available = 0;
+    QBENCHMARK {
+        QFile file("/proc/meminfo");
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            SystemMonitor::parseMemInfo(file.readAll(), &total, &available);
+        }
+    }
+}
+
+GHELPER_TEST(BenchSystemMonitor);
+
+#include "BenchSystemMonitor.moc"
@@ -0,0 +1,11 @@
+#include "TestSuite.h"
+#include "PrivateBus.h"
+#include <QCoreApplication>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // Before any client exists: SystemBus reads the address once
+    PrivateBus bus;
+    return TestSuite::runBenchmarks(argc, argv);
+}
@@ -0,0 +1,144 @@
+#include "MockAsusd.h"
+#include "FanCurveFixtures.h"
+#include <QDBusObjectPath>
+
+MockAsusd::MockAsusd(QObject *parent)
+    : MockService("xyz.ljones.Asusd", parent)
+{
+    registerDBusTypes();
+    // InterfacesAdded carries a{sa{sv}}
+    qDBusRegisterMetaType<QMap<QString, QVariantMap>>();
+
+    addObject(PATH, PLATFORM, {
+        {"PlatformProfile", QVariant::fromValue(quint32(1))},          // Balanced
+        {"ChargeControlEndThreshold", QVariant::fromValue(quint8(100))}
+    });
+    addObject(PATH, FAN_CURVES);
+    addAuraDevice(DEFAULT_AURA_NODE);
+
+    for (quint32 profile = 0; profile < 3; profile++) {
+        m_curves[profile] = defaultCurves(profile);
+    }
+    addMethods();
+}
+
+quint32 MockAsusd::platformProfile() const
+{
+    return property(PATH, PLATFORM, "PlatformProfile").toUInt();
+}
+
+quint8 MockAsusd::chargeLimit() const
+{
+    return static_cast<quint8>(property(PATH, PLATFORM, "ChargeControlEndThreshold").toUInt());
+}
+
+quint32 MockAsusd::brightness(const QString &node) const
+{
+    return property(auraPath(node), AURA, "Brightness").toUInt();
+}
+
+void MockAsusd::pressProfileHotkey(quint32 profile)
+{
+    changeProperty(PATH, PLATFORM, "PlatformProfile", QVariant::fromValue(profile));
+}
+
+void MockAsusd::addAuraDevice(const QString &node)
+{
+    const QVariantMap properties{
+        {"Brightness", QVariant::fromValue(quint32(2))},               // Medium
+        {"LedModeData", QVariant::fromValue(AuraEffect{0, 0, {255, 0, 0}, {0, 0, 0}, "Med", "Right"})}
+    };
+    addObject(auraPath(node), AURA, properties);
+
+    QMap<QString, QVariantMap> interfaces{{AURA, properties}};
+    emitSignal(PATH, "org.freedesktop.DBus.ObjectManager", "InterfacesAdded",
+               {QVariant::fromValue(QDBusObjectPath(auraPath(node))), QVariant::fromValue(interfaces)});
+}
+
+void MockAsusd::removeAuraDevice(const QString &node)
+{
+    removeObject(auraPath(node));
+    emitSignal(PATH, "org.freedesktop.DBus.ObjectManager", "InterfacesRemoved",
+               {QVariant::fromValue(QDBusObjectPath(auraPath(node))), QStringList{AURA}});
+}
+
+QList<AsusdCurveData> MockAsusd::defaultCurves(quint32 profile)
+{
+    // Quieter profiles start lower; PWM is 0-255 as asusd reports it
+    QList<AsusdCurveData> curves;
+    for (const char *fan : {"CPU", "GPU", "MID"}) {
+        AsusdCurveData curve{fan, QByteArray(FanCurveFixtures::POINTS, 0), QByteArray(FanCurveFixtures::POINTS, 0), false};
+        for (int i = 0; i < FanCurveFixtures::POINTS; i++) {
+            curve.temp[i] = static_cast<char>(FanCurveFixtures::temperature(i));
+            curve.pwm[i] = static_cast<char>(qMin(255, int(profile) * 20 + i * 30));
+        }
+        curves << curve;
+    }
+    return curves;
+}
+
+int MockAsusd::fanIndex(const QString &fan)
+{
+    const QStringList fans{"CPU", "GPU", "MID"};
+    return fans.indexOf(fan.toUpper());
+}
+
+void MockAsusd::addMethods()
+{
+    auto badProfile = [](quint32 profile, QDBusError *error) {
+        if (profile < 3) return false;
+        *error = QDBusError(QDBusError::InvalidArgs, "Unknown profile");
+        return true;
+    };
+
+    addMethod(FAN_CURVES, "FanCurveData", [this, badProfile](const QVariantList &args, QDBusError *error) {
+        const quint32 profile = args.value(0).toUInt();
+        if (badProfile(profile, error)) return QVariantList();
+        return QVariantList{QVariant::fromValue(m_curves.value(profile))};
+    });
+
+    addMethod(FAN_CURVES, "SetFanCurve", [this, badProfile](const QVariantList &args, QDBusError *error) {
+        const quint32 profile = args.value(0).toUInt();
+        if (badProfile(profile, error)) return QVariantList();
+
+        const AsusdCurveData curve = qdbus_cast<AsusdCurveData>(args.value(1));
+        const int fan = fanIndex(curve.fan);
+        if (fan < 0 || curve.pwm.size() != 8 || curve.temp.size() != 8) {
+            *error = QDBusError(QDBusError::InvalidArgs, "Bad fan curve");
+            return QVariantList();
+        }
+        // Setting a curve does not enable it; that is a separate call
+        const bool enabled = m_curves[profile][fan].enabled;
+        m_curves[profile][fan] = curve;
+        m_curves[profile][fan].enabled = enabled;
+        return QVariantList();
+    });
+
+    addMethod(FAN_CURVES, "SetFanCurvesEnabled", [this, badProfile](const QVariantList &args, QDBusError *error) {
+        const quint32 profile = args.value(0).toUInt();
+        if (badProfile(profile, error)) return QVariantList();
+        for (AsusdCurveData &curve : m_curves[profile]) {
+            curve.enabled = args.value(1).toBool();
+        }
+        return QVariantList();
+    });
+
+    addMethod(FAN_CURVES, "SetProfileFanCurveEnabled", [this, badProfile](const QVariantList &args, QDBusError *error) {
+        const quint32 profile = args.value(0).toUInt();
+        if (badProfile(profile, error)) return QVariantList();
+        const int fan = fanIndex(args.value(1).toString());
+        if (fan < 0) {
+            *error = QDBusError(QDBusError::InvalidArgs, "Unknown fan");
+            return QVariantList();
+        }
+        m_curves[profile][fan].enabled = args.value(2).toBool();
+        return QVariantList();
+    });
+
+    addMethod(FAN_CURVES, "ResetProfileCurves", [this, badProfile](const QVariantList &args, QDBusError *error) {
+        const quint32 profile = args.value(0).toUInt();
+        if (badProfile(profile, error)) return QVariantList();
+        m_curves[profile] = defaultCurves(profile);
+        return QVariantList();
+    });
+}
@@ -0,0 +1,47 @@
+#ifndef MOCKASUSD_H
+#define MOCKASUSD_H
+
+#include "MockService.h"
+#include "DBusTypes.h"
+
+// Stand-in asusd: xyz.ljones.Platform and xyz.ljones.FanCurves on
+// /xyz/ljones, one xyz.ljones.Aura node per keyboard device below
+// /xyz/ljones/aura. Fan curves are kept per profile in asusd's wire format.
+class MockAsusd : public MockService
+{
+    Q_OBJECT
+
+public:
+    explicit MockAsusd(QObject *parent = nullptr);
+
+    static constexpr const char* PATH = "/xyz/ljones";
+    static constexpr const char* PLATFORM = "xyz.ljones.Platform";
+    static constexpr const char* FAN_CURVES = "xyz.ljones.FanCurves";
+    static constexpr const char* AURA = "xyz.ljones.Aura";
+    static constexpr const char* DEFAULT_AURA_NODE = "19b6_3_4";
+
+    quint32 platformProfile() const;
+    quint8 chargeLimit() const;
+    quint32 brightness(const QString &node = DEFAULT_AURA_NODE) const;
+
+    // A change on the machine itself, e.g. Fn+F5 cycling the profile
+    void pressProfileHotkey(quint32 profile);
+
+    // Hotplug, announced through ObjectManager.InterfacesAdded/Removed
+    void addAuraDevice(const QString &node);
+    void removeAuraDevice(const QString &node);
+
+    // What asusd holds for a profile; index is the fan (CPU, GPU, MID)
+    QList<AsusdCurveData> fanCurves(quint32 profile) const { return m_curves.value(profile); }
+    void setFanCurves(quint32 profile, const QList<AsusdCurveData> &curves) { m_curves[profile] = curves; }
+    static QList<AsusdCurveData> defaultCurves(quint32 profile);
+
+private:
+    void addMethods();
+    static QString auraPath(const QString &node) { return QString("/xyz/ljones/aura/") + node; }
+    static int fanIndex(const QString &fan);
+
+    QHash<quint32, QList<AsusdCurveData>> m_curves;
+};
+
+#endif // MOCKASUSD_H
@@ -0,0 +1,246 @@
+#include "MockService.h"
+#include "PrivateBus.h"
+#include <QDBusVariant>
+#include <QDebug>
+#include <QTimer>
+
+namespace {
+constexpr const char *PROPERTIES = "org.freedesktop.DBus.Properties";
+constexpr const char *INTROSPECTABLE = "org.freedesktop.DBus.Introspectable";
+}
+
+MockService::MockService(const QString &service, QObject *parent)
+    : QDBusVirtualObject(parent)
+    , m_service(service)
+    , m_bus(QStringLiteral("mock-") + service)
+{
+}
+
+MockService::~MockService()
+{
+    stop();
+    if (m_registered) {
+        m_bus.unregisterObject("/", QDBusConnection::UnregisterTree);
+    }
+    QDBusConnection::disconnectFromBus(m_bus.name());
+}
+
+bool MockService::start()
+{
+    if (m_running) return true;
+    if (!PrivateBus::isRunning()) return false;
+
+    if (!m_bus.isConnected()) {
+        m_bus = QDBusConnection::connectToBus(PrivateBus::address(), m_bus.name());
+        if (!m_bus.isConnected()) {
+            qWarning() << "MockService: Cannot connect" << m_service << ":" << m_bus.lastError().message();
+            return false;
+        }
+    }
+
+    // Every path below "/" lands in handleMessage()
+    if (!m_registered) {
+        m_registered = m_bus.registerVirtualObject("/", this, QDBusConnection::SubPath);
+        if (!m_registered) {
+            qWarning() << "MockService: Cannot register objects for" << m_service;
+            return false;
+        }
+    }
+
+    m_running = m_bus.registerService(m_service);
+    return m_running;
+}
+
+void MockService::stop()
+{
+    if (!m_running) return;
+    m_running = false;
+    m_bus.unregisterService(m_service);
+}
+
+void MockService::setFailing(const QString &member, bool failing)
+{
+    if (failing) {
+        m_failing.insert(member);
+    } else {
+        m_failing.remove(member);
+    }
+}
+
+QVariant MockService::property(const QString &path, const QString &interface, const QString &name) const
+{
+    return m_properties.value(key(path, interface)).value(name);
+}
+
+void MockService::setPropertyQuietly(const QString &path, const QString &interface,
+                                     const QString &name, const QVariant &value)
+{
+    m_properties[key(path, interface)].insert(name, value);
+}
+
+void MockService::changeProperty(const QString &path, const QString &interface,
+                                 const QString &name, const QVariant &value)
+{
+    setPropertyQuietly(path, interface, name, value);
+    if (m_running) {
+        m_bus.send(propertiesChanged(path, interface, {{name, value}}));
+    }
+}
+
+void MockService::emitSignal(const QString &path, const QString &interface,
+                             const QString &name, const QVariantList &arguments)
+{
+    if (!m_running) return;
+
+    QDBusMessage signal = QDBusMessage::createSignal(path, interface, name);
+    signal.setArguments(arguments);
+    m_bus.send(signal);
+}
+
+void MockService::addObject(const QString &path, const QString &interface, const QVariantMap &properties)
+{
+    if (!m_objects[path].contains(interface)) {
+        m_objects[path].append(interface);
+    }
+    m_properties[key(path, interface)].insert(properties);
+}
+
+void MockService::removeObject(const QString &path)
+{
+    for (const QString &interface : m_objects.take(path)) {
+        m_properties.remove(key(path, interface));
+    }
+}
+
+void MockService::addMethod(const QString &interface, const QString &member, Method method)
+{
+    m_methods.insert(key(interface, member), std::move(method));
+}
+
+QString MockService::introspect(const QString &path) const
+{
+    QString xml;
+    for (const QString &interface : m_objects.value(path)) {
+        xml += QStringLiteral("  <interface name=\"%1\"/>\n").arg(interface);
+    }
+    return xml;
+}
+
+bool MockService::handleMessage(const QDBusMessage &message, const QDBusConnection &connection)
+{
+    Q_UNUSED(connection)
+    // QtDBus may call this from its own thread; all state lives on ours
+    QMetaObject::invokeMethod(this, [this, message]() { dispatch(message); }, Qt::QueuedConnection);
+    return true;
+}
+
+void MockService::dispatch(const QDBusMessage &message)
+{
+    const QString member = message.member();
+    m_calls[member]++;
+
+    if (!m_running) return;
+
+    if (m_failing.contains(member)) {
+        reply({message.createErrorReply(QDBusError::Failed, "Mock failure: " + member)});
+        return;
+    }
+
+    if (message.interface() == QLatin1String(INTROSPECTABLE) && member == "Introspect") {
+        // Direct children only, as a real object tree would report them
+        const QString prefix = message.path() == "/" ? QStringLiteral("/") : message.path() + '/';
+        QSet<QString> children;
+        for (auto it = m_objects.constBegin(); it != m_objects.constEnd(); ++it) {
+            if (it.key().startsWith(prefix)) {
+                children.insert(it.key().mid(prefix.size()).section('/', 0, 0));
+            }
+        }
+        QString xml = "<!DOCTYPE node PUBLIC \"-//freedesktop//DTD D-BUS Object Introspection 1.0//EN\"\n"
+                      " \"http://www.freedesktop.org/standards/dbus/1.0/introspect.dtd\">\n<node>\n";
+        xml += introspect(message.path());
+        for (const QString &child : std::as_const(children)) {
+            xml += QStringLiteral("  <node name=\"%1\"/>\n").arg(child);
+        }
+        xml += "</node>\n";
+        reply({message.createReply(xml)});
+        return;
+    }
+
+    if (message.interface() == QLatin1String(PROPERTIES)) {
+        // The reply goes first, its echo (if any) after it
+        QDBusMessage echo;
+        const QDBusMessage answer = handleProperties(message, &echo);
+        reply(echo.type() == QDBusMessage::InvalidMessage ? QList<QDBusMessage>{answer}
+                                                          : QList<QDBusMessage>{answer, echo});
+        return;
+    }
+
+    // Generated proxies always name the interface
+    auto method = m_methods.constFind(key(message.interface(), member));
+    if (method == m_methods.constEnd() || !m_objects.value(message.path()).contains(message.interface())) {
+        reply({message.createErrorReply(QDBusError::UnknownMethod, "No such method: " + member)});
+        return;
+    }
+
+    QDBusError error;
+    const QVariantList arguments = method.value()(message.arguments(), &error);
+    reply({error.isValid() ? message.createErrorReply(error) : message.createReply(arguments)});
+}
+
+QDBusMessage MockService::handleProperties(const QDBusMessage &message, QDBusMessage *echo)
+{
+    const QVariantList args = message.arguments();
+    const QString interface = args.value(0).toString();
+    auto values = m_properties.find(key(message.path(), interface));
+    if (values == m_properties.end()) {
+        return message.createErrorReply(QDBusError::UnknownInterface, "No such interface: " + interface);
+    }
+
+    if (message.member() == "GetAll") {
+        return message.createReply(QVariant::fromValue(values.value()));
+    }
+
+    const QString name = args.value(1).toString();
+    if (!values->contains(name)) {
+        return message.createErrorReply(QDBusError::UnknownProperty, "No such property: " + name);
+    }
+
+    if (message.member() == "Get") {
+        return message.createReply(QVariant::fromValue(QDBusVariant(values->value(name))));
+    }
+
+    if (message.member() == "Set") {
+        // Structured values stay as QDBusArgument and are sent back as is
+        const QVariant value = args.value(2).value<QDBusVariant>().variant();
+        values->insert(name, value);
+        if (m_echoWrites) {
+            *echo = propertiesChanged(message.path(), interface, {{name, value}});
+        }
+        return message.createReply();
+    }
+
+    return message.createErrorReply(QDBusError::UnknownMethod, "No such method: " + message.member());
+}
+
+QDBusMessage MockService::propertiesChanged(const QString &path, const QString &interface,
+                                            const QVariantMap &changed) const
+{
+    QDBusMessage signal = QDBusMessage::createSignal(path, PROPERTIES, "PropertiesChanged");
+    signal << interface << QVariant::fromValue(changed) << QStringList();
+    return signal;
+}
+
+void MockService::reply(const QList<QDBusMessage> &outgoing)
+{
+    auto send = [this, outgoing]() {
+        for (const QDBusMessage &message : outgoing) {
+            m_bus.send(message);
+        }
+    };
+
+    if (m_latency > 0) {
+        QTimer::singleShot(m_latency, this, send);
+    } else {
+        send();
+    }
+}
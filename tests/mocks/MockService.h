@@ -0,0 +1,102 @@
+#ifndef MOCKSERVICE_H
+#define MOCKSERVICE_H
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusVirtualObject>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QVariantMap>
+#include <functional>
+
+// A scriptable stand-in daemon on the private test bus.
+//
+// Objects are property tables plus method handlers, served through one
+// QDBusVirtualObject so every message (Introspect, Properties.Get/GetAll/Set
+// and the daemon's own methods) goes through dispatch() and can be:
+//
+//  - delayed:  setLatency() holds every reply back by that many ms
+//  - failed:   setFailing("Set") answers that member with an error
+//  - counted:  callCount("SetFanCurve")
+//
+// Property writes are echoed with PropertiesChanged after the reply, as
+// asusd does; changeProperty() emits one for a change made "on the daemon"
+// (a hotkey, another client). stop()/start() release and re-take the bus
+// name, which clients see as the daemon exiting and coming back.
+class MockService : public QDBusVirtualObject
+{
+    Q_OBJECT
+
+public:
+    explicit MockService(const QString &service, QObject *parent = nullptr);
+    ~MockService() override;
+
+    QString service() const { return m_service; }
+
+    // Connects to the private bus and takes the well-known name
+    bool start();
+    // Releases the name (NameOwnerChanged), like a daemon exiting
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    void setLatency(int msecs) { m_latency = msecs; }
+    int latency() const { return m_latency; }
+    void setFailing(const QString &member, bool failing);
+    // Whether a Set is echoed with PropertiesChanged
+    void setEchoWrites(bool echo) { m_echoWrites = echo; }
+
+    int callCount(const QString &member) const { return m_calls.value(member); }
+    void resetCallCounts() { m_calls.clear(); }
+
+    QVariant property(const QString &path, const QString &interface, const QString &name) const;
+    // A change made on the daemon's side, announced with PropertiesChanged
+    void changeProperty(const QString &path, const QString &interface,
+                        const QString &name, const QVariant &value);
+    void emitSignal(const QString &path, const QString &interface,
+                    const QString &name, const QVariantList &arguments);
+
+    QString introspect(const QString &path) const override;
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override;
+
+protected:
+    // Returns the reply arguments; set *error to fail the call
+    using Method = std::function<QVariantList(const QVariantList &arguments, QDBusError *error)>;
+
+    void addObject(const QString &path, const QString &interface,
+                   const QVariantMap &properties = QVariantMap());
+    void removeObject(const QString &path);
+    bool hasObject(const QString &path) const { return m_objects.contains(path); }
+    void addMethod(const QString &interface, const QString &member, Method method);
+    void setPropertyQuietly(const QString &path, const QString &interface,
+                            const QString &name, const QVariant &value);
+
+    QDBusConnection connection() const { return m_bus; }
+
+private:
+    void dispatch(const QDBusMessage &message);
+    // Runs on the main thread; outgoing is sent as one unit after the latency
+    void reply(const QList<QDBusMessage> &outgoing);
+    // The reply; *echo is set to the PropertiesChanged a Set causes
+    QDBusMessage handleProperties(const QDBusMessage &message, QDBusMessage *echo);
+    QDBusMessage propertiesChanged(const QString &path, const QString &interface,
+                                   const QVariantMap &changed) const;
+
+    static QString key(const QString &path, const QString &interface) { return path + '|' + interface; }
+
+    QString m_service;
+    QDBusConnection m_bus;
+    bool m_running = false;
+    bool m_registered = false;
+
+    int m_latency = 0;
+    bool m_echoWrites = true;
+    QSet<QString> m_failing;
+    QHash<QString, int> m_calls;
+
+    QMap<QString, QStringList> m_objects;       // path -> interfaces
+    QHash<QString, QVariantMap> m_properties;   // path|interface -> values
+    QHash<QString, Method> m_methods;           // interface|member -> handler
+};
+
+#endif // MOCKSERVICE_H
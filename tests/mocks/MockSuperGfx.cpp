@@ -0,0 +1,52 @@
+#include "MockSuperGfx.h"
+
+MockSuperGfx::MockSuperGfx(QObject *parent)
+    : MockService("org.supergfxctl.Daemon", parent)
+{
+    addObject(PATH, INTERFACE);
+
+    addMethod(INTERFACE, "Mode", [this](const QVariantList &, QDBusError *) {
+        return QVariantList{QVariant::fromValue(m_mode)};
+    });
+    addMethod(INTERFACE, "Supported", [this](const QVariantList &, QDBusError *) {
+        return QVariantList{QVariant::fromValue(m_supported)};
+    });
+    addMethod(INTERFACE, "Power", [this](const QVariantList &, QDBusError *) {
+        return QVariantList{QVariant::fromValue(m_power)};
+    });
+    addMethod(INTERFACE, "SetMode", [this](const QVariantList &args, QDBusError *error) {
+        const quint32 mode = args.value(0).toUInt();
+        if (!m_supported.contains(mode)) {
+            *error = QDBusError(QDBusError::InvalidArgs, "Mode not supported");
+            return QVariantList();
+        }
+        // The action: 0 none, 1 logout required
+        if (needsLogout(m_mode, mode)) {
+            m_pendingMode = mode;
+            return QVariantList{QVariant::fromValue(quint32(1))};
+        }
+        m_mode = mode;
+        emitSignal(PATH, INTERFACE, "NotifyGfxStatus", {QVariant::fromValue(m_power)});
+        return QVariantList{QVariant::fromValue(quint32(0))};
+    });
+}
+
+void MockSuperGfx::setPower(quint32 power)
+{
+    m_power = power;
+    emitSignal(PATH, INTERFACE, "NotifyGfxStatus", {QVariant::fromValue(power)});
+}
+
+void MockSuperGfx::completeSwitch()
+{
+    if (m_pendingMode == 5) return;
+    m_mode = m_pendingMode;
+    m_pendingMode = 5;
+    emitSignal(PATH, INTERFACE, "NotifyGfxStatus", {QVariant::fromValue(m_power)});
+}
+
+bool MockSuperGfx::needsLogout(quint32 from, quint32 to)
+{
+    // Same rule as SuperGfxClient::requiresLogout: MUX and VFIO switches
+    return from == 2 || to == 2 || from == 3 || to == 3;
+}
@@ -0,0 +1,36 @@
+#ifndef MOCKSUPERGFX_H
+#define MOCKSUPERGFX_H
+
+#include "MockService.h"
+
+// Stand-in supergfxd: org.supergfxctl.Daemon on /org/supergfxctl/Gfx.
+// Switches that need a logout stay pending until completeSwitch().
+class MockSuperGfx : public MockService
+{
+    Q_OBJECT
+
+public:
+    explicit MockSuperGfx(QObject *parent = nullptr);
+
+    static constexpr const char* PATH = "/org/supergfxctl/Gfx";
+    static constexpr const char* INTERFACE = "org.supergfxctl.Daemon";
+
+    quint32 mode() const { return m_mode; }
+    quint32 pendingMode() const { return m_pendingMode; }
+    void setSupported(const QList<uint> &modes) { m_supported = modes; }
+
+    // dGPU power state (0 Active, 1 Suspended, 2 Off); announced with NotifyGfxStatus
+    void setPower(quint32 power);
+    // The logout happened: the pending mode becomes current
+    void completeSwitch();
+
+private:
+    static bool needsLogout(quint32 from, quint32 to);
+
+    quint32 m_mode = 1;   // Hybrid
+    quint32 m_pendingMode = 5; // None
+    quint32 m_power = 1;  // Suspended
+    QList<uint> m_supported{0, 1, 2};
+};
+
+#endif // MOCKSUPERGFX_H
@@ -0,0 +1,35 @@
+#include "FanCurveFixtures.h"
+#include <QVariantMap>
+
+namespace FanCurveFixtures {
+
+int temperature(int point)
+{
+    return 30 + point * 10;
+}
+
+int fanPercent(int point, int offset)
+{
+    return qMin(100, offset + point * 12);
+}
+
+FanCurveData curve(quint32 profile, quint32 fan, int offset)
+{
+    FanCurveData data{profile, fan, true, {}};
+    for (int i = 0; i < POINTS; i++) {
+        data.points.append(FanCurvePoint{static_cast<quint8>(temperature(i)),
+                                         static_cast<quint8>(fanPercent(i, offset))});
+    }
+    return data;
+}
+
+QVariantList points(int offset)
+{
+    QVariantList result;
+    for (int i = 0; i < POINTS; i++) {
+        result.append(QVariantMap{{"temp", temperature(i)}, {"fan", fanPercent(i, offset)}});
+    }
+    return result;
+}
+
+} // namespace FanCurveFixtures
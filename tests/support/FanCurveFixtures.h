@@ -0,0 +1,25 @@
+#ifndef FANCURVEFIXTURES_H
+#define FANCURVEFIXTURES_H
+
+#include "DBusTypes.h"
+#include <QVariantList>
+
+// The fan curves the tests, benchmarks and MockAsusd work with: POINTS
+// points from 30 to 100 C in steps of 10, like asusd's own. `offset` sets
+// the duty of the first point; each later one adds 12%, capped at 100, so
+// curves with different offsets differ in every point.
+namespace FanCurveFixtures {
+
+constexpr int POINTS = 8;
+
+int temperature(int point);
+int fanPercent(int point, int offset);
+
+// As AsusdClient::setFanCurves() takes it
+FanCurveData curve(quint32 profile, quint32 fan, int offset);
+// As FanCurveStore and QML hold it: {"temp", "fan"} maps
+QVariantList points(int offset);
+
+} // namespace FanCurveFixtures
+
+#endif // FANCURVEFIXTURES_H
@@ -0,0 +1,76 @@
+#include "PrivateBus.h"
+#include "SystemBus.h"
+#include <QDebug>
+#include <QFile>
+#include <QStandardPaths>
+
+QString PrivateBus::s_address;
+
+namespace {
+// Anyone may own any name and talk to anyone: it only hosts the mocks
+constexpr const char *CONFIG = R"(<!DOCTYPE busconfig PUBLIC "-//freedesktop//DTD D-Bus Bus Configuration 1.0//EN"
+ "http://www.freedesktop.org/standards/dbus/1.0/busconfig.dtd">
+<busconfig>
+  <type>session</type>
+  <listen>unix:dir=%1</listen>
+  <auth>EXTERNAL</auth>
+  <policy context="default">
+    <allow send_destination="*" eavesdrop="true"/>
+    <allow eavesdrop="true"/>
+    <allow own="*"/>
+  </policy>
+</busconfig>
+)";
+}
+
+PrivateBus::PrivateBus()
+{
+    const QString program = QStandardPaths::findExecutable("dbus-daemon");
+    if (program.isEmpty() || !m_dir.isValid()) {
+        qWarning() << "PrivateBus: dbus-daemon not available, D-Bus suites will be skipped";
+        return;
+    }
+
+    const QString configPath = m_dir.filePath("bus.conf");
+    QFile config(configPath);
+    if (!config.open(QIODevice::WriteOnly)
+        || config.write(QString::fromLatin1(CONFIG).arg(m_dir.path()).toUtf8()) < 0) {
+        qWarning() << "PrivateBus: Cannot write" << configPath;
+        return;
+    }
+    config.close();
+
+    m_daemon.setProgram(program);
+    m_daemon.setArguments({"--config-file=" + configPath, "--nofork", "--nopidfile", "--print-address"});
+    m_daemon.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    m_daemon.start();
+
+    // The address is the first line it prints
+    QByteArray line;
+    while (!line.endsWith('\n') && m_daemon.waitForReadyRead(STARTUP_TIMEOUT_MS)) {
+        line += m_daemon.readLine();
+    }
+    const QString address = QString::fromUtf8(line).trimmed();
+    if (address.isEmpty()) {
+        qWarning() << "PrivateBus: dbus-daemon did not start:" << m_daemon.errorString();
+        m_daemon.kill();
+        m_daemon.waitForFinished();
+        return;
+    }
+
+    qputenv(SystemBus::ADDRESS_ENV, address.toUtf8());
+    s_address = address;
+    qDebug() << "PrivateBus: Running at" << address;
+}
+
+PrivateBus::~PrivateBus()
+{
+    if (m_daemon.state() == QProcess::NotRunning) return;
+
+    s_address.clear();
+    m_daemon.terminate();
+    if (!m_daemon.waitForFinished(STARTUP_TIMEOUT_MS)) {
+        m_daemon.kill();
+        m_daemon.waitForFinished();
+    }
+}
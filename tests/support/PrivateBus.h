@@ -0,0 +1,35 @@
+#ifndef PRIVATEBUS_H
+#define PRIVATEBUS_H
+
+#include <QProcess>
+#include <QString>
+#include <QTemporaryDir>
+
+// A dbus-daemon of our own for the mock services.
+//
+// The runners' main() starts one per run, before any client exists: its
+// address goes into GHELPER_DBUS_ADDRESS, so SystemBus connects every
+// AsusdClient, SuperGfxClient and DBusWatcher under test to it instead of
+// the system bus. Suites that need it skip when dbus-daemon is missing.
+class PrivateBus
+{
+public:
+    PrivateBus();
+    ~PrivateBus();
+
+    PrivateBus(const PrivateBus &) = delete;
+    PrivateBus &operator=(const PrivateBus &) = delete;
+
+    static bool isRunning() { return !s_address.isEmpty(); }
+    static QString address() { return s_address; }
+
+private:
+    QTemporaryDir m_dir;
+    QProcess m_daemon;
+
+    static QString s_address;
+
+    static constexpr int STARTUP_TIMEOUT_MS = 5000;
+};
+
+#endif // PRIVATEBUS_H
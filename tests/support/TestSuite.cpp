@@ -0,0 +1,163 @@
+#include "TestSuite.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QSaveFile>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QXmlStreamReader>
+#include <memory>
+
+namespace {
+
+struct Entry {
+    const char *name;
+    TestSuite::Factory factory;
+};
+
+// Filled by static initialisers, so it must not be a plain global
+QList<Entry> &registry()
+{
+    static QList<Entry> entries;
+    return entries;
+}
+
+// Splits our own options off the QtTest ones
+struct Options {
+    QStringList qtestArgs;
+    QString suite;
+    QString jsonPath = QStringLiteral("ghelper_bench.json");
+};
+
+Options parseOptions(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 0; i < argc; i++) {
+        const QString arg = QString::fromLocal8Bit(argv[i]);
+        if (arg == "-suite" && i + 1 < argc) {
+            options.suite = QString::fromLocal8Bit(argv[++i]);
+        } else if (arg == "-json" && i + 1 < argc) {
+            options.jsonPath = QString::fromLocal8Bit(argv[++i]);
+        } else {
+            options.qtestArgs << arg;
+        }
+    }
+    return options;
+}
+
+// QtTest's XML log holds one BenchmarkResult per benchmarked function and
+// data tag; the value is already divided by the iteration count
+void collectResults(const QString &suite, const QString &xmlPath, QJsonArray &results)
+{
+    QFile file(xmlPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "TestSuite: No benchmark log for" << suite;
+        return;
+    }
+
+    QXmlStreamReader xml(&file);
+    QString function;
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) continue;
+
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == u"TestFunction") {
+            function = attributes.value("name").toString();
+        } else if (xml.name() == u"BenchmarkResult") {
+            results.append(QJsonObject{
+                {"suite", suite},
+                {"test", function},
+                {"tag", attributes.value("tag").toString()},
+                {"metric", attributes.value("metric").toString()},
+                {"value", attributes.value("value").toDouble()},
+                {"iterations", attributes.value("iterations").toInt()}
+            });
+        }
+    }
+    if (xml.hasError()) {
+        qWarning() << "TestSuite: Bad benchmark log for" << suite << ":" << xml.errorString();
+    }
+}
+
+int runAll(const Options &options, const std::function<QStringList(const QString &)> &extraArgs)
+{
+    int failed = 0;
+    bool found = false;
+    for (const Entry &entry : std::as_const(registry())) {
+        if (!options.suite.isEmpty() && options.suite != QLatin1String(entry.name)) continue;
+        found = true;
+
+        std::unique_ptr<QObject> test(entry.factory());
+        QStringList args = options.qtestArgs;
+        if (extraArgs) args << extraArgs(QLatin1String(entry.name));
+        if (QTest::qExec(test.get(), args) != 0) {
+            failed++;
+        }
+    }
+
+    if (!found) {
+        qWarning() << "TestSuite: No test class named" << options.suite;
+        return 1;
+    }
+    return failed;
+}
+
+} // namespace
+
+namespace TestSuite {
+
+bool add(const char *name, Factory factory)
+{
+    registry().append({name, std::move(factory)});
+    return true;
+}
+
+int run(int argc, char *argv[])
+{
+    return runAll(parseOptions(argc, argv), {});
+}
+
+int runBenchmarks(int argc, char *argv[])
+{
+    const Options options = parseOptions(argc, argv);
+
+    QTemporaryDir logDir;
+    if (!logDir.isValid()) {
+        qWarning() << "TestSuite: Cannot create a directory for benchmark logs";
+        return 1;
+    }
+
+    // Text to the console as usual, XML next to it for the JSON summary
+    const int failed = runAll(options, [&logDir](const QString &suite) {
+        return QStringList{"-o", logDir.filePath(suite + ".xml") + ",xml", "-o", "-,txt"};
+    });
+
+    QJsonArray results;
+    for (const Entry &entry : std::as_const(registry())) {
+        const QString suite = QLatin1String(entry.name);
+        if (!options.suite.isEmpty() && options.suite != suite) continue;
+        collectResults(suite, logDir.filePath(suite + ".xml"), results);
+    }
+
+    const QJsonObject root{
+        {"timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"qtVersion", QString::fromLatin1(qVersion())},
+        {"results", results}
+    };
+
+    QSaveFile file(options.jsonPath);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(QJsonDocument(root).toJson()) < 0
+        || !file.commit()) {
+        qWarning() << "TestSuite: Failed to write" << options.jsonPath;
+        return failed + 1;
+    }
+    qInfo().noquote() << "Benchmark results:" << options.jsonPath;
+    return failed;
+}
+
+} // namespace TestSuite
@@ -0,0 +1,31 @@
+#ifndef TESTSUITE_H
+#define TESTSUITE_H
+
+#include <QObject>
+#include <QString>
+#include <functional>
+
+// The QtTest classes linked into one runner (ghelper_tests, ghelper_bench).
+//
+// Each class registers itself with GHELPER_TEST(Class) in its own .cpp;
+// the runner's main() calls run() or runBenchmarks(). Besides the usual
+// QtTest arguments both accept "-suite <Class>" to run one class only.
+namespace TestSuite {
+
+using Factory = std::function<QObject *()>;
+
+bool add(const char *name, Factory factory);
+
+// Runs every registered class; returns the number of failed classes
+int run(int argc, char *argv[]);
+
+// As run(), and also writes every QBENCHMARK result to a JSON file
+// ("-json <path>", default ghelper_bench.json) for tracking over time
+int runBenchmarks(int argc, char *argv[]);
+
+} // namespace TestSuite
+
+#define GHELPER_TEST(Class) \
+    [[maybe_unused]] static const bool Class##Registered = TestSuite::add(#Class, []() -> QObject * { return new Class; })
+
+#endif // TESTSUITE_H
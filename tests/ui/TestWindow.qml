@@ -0,0 +1,13 @@
+import QtQuick
+import QtQuick.Window
+import GHelperTest
+
+// Stands in for Main.qml: hidden until WindowHost shows it, and bound to a
+// C++ singleton that outlives every engine
+Window {
+    visible: false
+    width: 200
+    height: 100
+
+    property int counter: Counter.value
+}
@@ -0,0 +1,105 @@
+#include "TestSuite.h"
+#include "LazySingleton.h"
+#include "WindowHost.h"
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QQuickWindow>
+#include <QSignalSpy>
+#include <QTest>
+
+namespace {
+
+class Counter : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int value READ value NOTIFY valueChanged)
+
+public:
+    int value() const { return m_value; }
+    void setValue(int value)
+    {
+        if (m_value == value) return;
+        m_value = value;
+        emit valueChanged();
+    }
+
+signals:
+    void valueChanged();
+
+private:
+    int m_value = 0;
+};
+
+} // namespace
+
+// The UI is built and torn down on demand; the C++ singletons it uses must
+// serve every engine, not just the first one
+class TestWindowHost : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void showUnloadShow();
+    void showIsTimedFromRequest();
+
+private:
+    static constexpr int REQUEST_DELAY_MS = 100;
+
+    Counter m_counter;
+};
+
+void TestWindowHost::initTestCase()
+{
+    registerQmlInstance("GHelperTest", 1, 0, "Counter", &m_counter);
+}
+
+void TestWindowHost::showUnloadShow()
+{
+    WindowHost host(QUrl("qrc:/ui/TestWindow.qml"));
+    host.setUnloadDelay(0);
+    QSignalSpy failed(&host, &WindowHost::loadFailed);
+
+    m_counter.setValue(1);
+    host.show();
+    QVERIFY(host.isLoaded());
+    QVERIFY(host.isVisible());
+    QCOMPARE(host.window()->property("counter").toInt(), 1);
+
+    QPointer<QQuickWindow> first = host.window();
+    host.hide();
+    host.unload();
+    QVERIFY(!host.isLoaded());
+    // The engine goes with deleteLater(), and its window with it
+    QTRY_VERIFY(first.isNull());
+
+    // A second engine gets the same, still living instance
+    m_counter.setValue(2);
+    host.show();
+    QVERIFY(failed.isEmpty());
+    QVERIFY(host.isLoaded());
+    QVERIFY(host.isVisible());
+    QCOMPARE(host.window()->property("counter").toInt(), 2);
+
+    m_counter.setValue(3);
+    QCOMPARE(host.window()->property("counter").toInt(), 3);
+}
+
+void TestWindowHost::showIsTimedFromRequest()
+{
+    WindowHost host(QUrl("qrc:/ui/TestWindow.qml"));
+    QSignalSpy shown(&host, &WindowHost::shown);
+
+    // A tray click some time before the show call itself
+    QElapsedTimer since;
+    since.start();
+    QTest::qWait(REQUEST_DELAY_MS);
+    host.showSince(since);
+
+    QTRY_COMPARE(shown.count(), 1);
+    QVERIFY(shown.at(0).at(0).toLongLong() >= REQUEST_DELAY_MS);
+}
+
+GHELPER_TEST(TestWindowHost);
+
+#include "TestWindowHost.moc"
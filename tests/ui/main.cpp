@@ -0,0 +1,14 @@
+#include "TestSuite.h"
+#include <QGuiApplication>
+
+int main(int argc, char *argv[])
+{
+    // Real windows and scene graphs, but no display needed
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+        // Frames are presented (frameSwapped) without a GPU
+        qputenv("QT_QUICK_BACKEND", "software");
+    }
+    QGuiApplication app(argc, argv);
+    return TestSuite::run(argc, argv);
+}
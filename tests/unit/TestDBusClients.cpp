@@ -0,0 +1,330 @@
+#include "TestSuite.h"
+#include "PrivateBus.h"
+#include "MockAsusd.h"
+#include "MockSuperGfx.h"
+#include "FanCurveFixtures.h"
+#include "AsusdClient.h"
+#include "SuperGfxClient.h"
+#include "DBusWatcher.h"
+#include "LatencyStats.h"
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTest>
+#include <memory>
+
+using FanCurveFixtures::curve;
+
+// AsusdClient, SuperGfxClient and DBusWatcher against the mock daemons
+class TestDBusClients : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void asusdInitialState();
+    void profileWriteRoundTrip();
+    void hotkeyChangeIsApplied();
+    void failedWriteFallsBack();
+    void slowDaemonDoesNotBlock();
+    void programmedCurvesAreNotRewritten();
+    void resetFanCurvesUsesDaemon();
+    void auraHotplug();
+    void asusdExitAndReturn();
+    void gpuModeSwitch();
+    void gpuSwitchNeedingLogout();
+    void gpuDaemonRegistersLate();
+    void watcherFollowsNameOwner();
+
+private:
+    std::unique_ptr<AsusdClient> connectedAsusd();
+    static AsusdCurveData wire(const FanCurveData &curve);
+
+    std::unique_ptr<MockAsusd> m_asusd;
+    std::unique_ptr<MockSuperGfx> m_gfx;
+};
+
+void TestDBusClients::initTestCase()
+{
+    if (!PrivateBus::isRunning()) {
+        QSKIP("dbus-daemon is not available");
+    }
+    m_asusd = std::make_unique<MockAsusd>();
+    m_gfx = std::make_unique<MockSuperGfx>();
+    QVERIFY(m_asusd->start());
+    QVERIFY(m_gfx->start());
+}
+
+void TestDBusClients::init()
+{
+    // Every test starts from a healthy, idle daemon
+    for (MockService *mock : {static_cast<MockService *>(m_asusd.get()), static_cast<MockService *>(m_gfx.get())}) {
+        QVERIFY(mock->start());
+        mock->setLatency(0);
+        mock->setFailing("Set", false);
+        mock->resetCallCounts();
+    }
+}
+
+void TestDBusClients::cleanupTestCase()
+{
+    m_gfx.reset();
+    m_asusd.reset();
+}
+
+std::unique_ptr<AsusdClient> TestDBusClients::connectedAsusd()
+{
+    auto client = std::make_unique<AsusdClient>();
+    if (!QTest::qWaitFor([&client]() { return client->isConnected(); })) {
+        return nullptr;
+    }
+    // First GetAll of the platform interface
+    QTest::qWaitFor([this, &client]() { return client->platformProfile() == m_asusd->platformProfile(); });
+    return client;
+}
+
+AsusdCurveData TestDBusClients::wire(const FanCurveData &curve)
+{
+    // asusd holds the duty cycle as 0-255
+    AsusdCurveData data{QStringList{"CPU", "GPU", "MID"}.value(curve.fanType), QByteArray(8, 0), QByteArray(8, 0), curve.enabled};
+    for (int i = 0; i < 8; i++) {
+        data.pwm[i] = static_cast<char>((curve.points[i].fanPercent * 255 + 50) / 100);
+        data.temp[i] = static_cast<char>(curve.points[i].temperature);
+    }
+    return data;
+}
+
+void TestDBusClients::asusdInitialState()
+{
+    m_asusd->pressProfileHotkey(2);
+    auto client = connectedAsusd();
+    QVERIFY(client);
+
+    QCOMPARE(client->platformProfile(), 2u);
+    QTRY_COMPARE(client->chargeLimit(), m_asusd->chargeLimit());
+    QTRY_COMPARE(client->auraDevices(), QStringList{MockAsusd::DEFAULT_AURA_NODE});
+    QTRY_COMPARE(client->ledBrightness(), m_asusd->brightness());
+}
+
+void TestDBusClients::profileWriteRoundTrip()
+{
+    m_asusd->pressProfileHotkey(1);
+    auto client = connectedAsusd();
+    QVERIFY(client);
+
+    QSignalSpy changed(client.get(), &AsusdClient::platformProfileChanged);
+    QSignalSpy errors(client.get(), &AsusdClient::errorOccurred);
+    client->setPlatformProfile(0);
+
+    QTRY_COMPARE(m_asusd->platformProfile(), 0u);
+    QTRY_COMPARE(m_asusd->callCount("Set"), 1);
+    // The echo confirms our own write: no flicker, no error
+    QTest::qWait(50);
+    QCOMPARE(client->platformProfile(), 0u);
+    QVERIFY(changed.isEmpty());
+    QVERIFY(errors.isEmpty());
+}
+
+void TestDBusClients::hotkeyChangeIsApplied()
+{
+    auto client = connectedAsusd();
+    QVERIFY(client);
+
+    const quint32 next = (client->platformProfile() + 1) % 3;
+    QSignalSpy changed(client.get(), &AsusdClient::platformProfileChanged);
+    m_asusd->pressProfileHotkey(next);
+
+    QTRY_COMPARE(changed.count(), 1);
+    QCOMPARE(client->platformProfile(), next);
+}
+
+void TestDBusClients::failedWriteFallsBack()
+{
+    auto client = connectedAsusd();
+    QVERIFY(client);
+    QTRY_COMPARE(client->chargeLimit(), m_asusd->chargeLimit());
+    const quint8 daemonLimit = m_asusd->chargeLimit();
+
+    m_asusd->setFailing("Set", true);
+    QSignalSpy errors(client.get(), &AsusdClient::errorOccurred);
+    client->setChargeLimit(60);
+    QCOMPARE(client->chargeLimit(), quint8(60));
+
+    QTRY_COMPARE(errors.count(), 1);
+    QCOMPARE(client->chargeLimit(), daemonLimit);
+    QCOMPARE(m_asusd->chargeLimit(), daemonLimit);
+}
+
+void TestDBusClients::slowDaemonDoesNotBlock()
+{
+    auto client = connectedAsusd();
+    QVERIFY(client);
+
+    m_asusd->setLatency(500);
+    const qint64 before = LatencyStats::instance()->count(LatencyStats::SetPlatformProfile);
+
+    QElapsedTimer timer;
+    timer.start();
+    client->setPlatformProfile((client->platformProfile() + 1) % 3);
+    client->refresh();
+    QVERIFY2(timer.elapsed() < 100, "A client call waited for the daemon");
+
+    // The reply still arrives, just late
+    QTRY_COMPARE_WITH_TIMEOUT(LatencyStats::instance()->count(LatencyStats::SetPlatformProfile), before + 1, 2000);
+}
+
+void TestDBusClients::programmedCurvesAreNotRewritten()
+{
+    const QList<FanCurveData> curves{curve(1, 0, 5), curve(1, 1, 10), curve(1, 2, 15)};
+    QList<AsusdCurveData> onDaemon;
+    for (const FanCurveData &c : curves) {
+        onDaemon << wire(c);
+    }
+    m_asusd->setFanCurves(1, onDaemon);
+
+    const qint64 reads = LatencyStats::instance()->count(LatencyStats::ReadFanCurves);
+    auto client = connectedAsusd();
+    QVERIFY(client);
+    // Connecting reads every profile's curves into the shadow copy
+    QTRY_VERIFY(LatencyStats::instance()->count(LatencyStats::ReadFanCurves) >= reads + 3);
+
+    client->setFanCurves(1, curves);
+    QCOMPARE(client->fanCurveWritesAvoided(), 3);
+    QTest::qWait(50);
+    QCOMPARE(m_asusd->callCount("SetFanCurve"), 0);
+
+    // A real change is still written, and only that one
+    QList<FanCurveData> edited = curves;
+    edited[1] = curve(1, 1, 30);
+    client->setFanCurves(1, edited);
+    QTRY_COMPARE(m_asusd->callCount("SetFanCurve"), 1);
+    QCOMPARE(m_asusd->fanCurves(1).value(1).pwm, wire(edited[1]).pwm);
+}
+
+void TestDBusClients::resetFanCurvesUsesDaemon()
+{
+    m_asusd->setFanCurves(2, {wire(curve(2, 0, 40)), wire(curve(2, 1, 40)), wire(curve(2, 2, 40))});
+    auto client = connectedAsusd();
+    QVERIFY(client);
+
+    QSignalSpy changed(client.get(), &AsusdClient::fanCurvesChanged);
+    const int reads = m_asusd->callCount("FanCurveData");
+    client->resetFanCurves(2);
+
+    QTRY_COMPARE(changed.count(), 1);
+    QCOMPARE(m_asusd->callCount("ResetProfileCurves"), 1);
+    QVERIFY(m_asusd->callCount("FanCurveData") > reads);
+    QCOMPARE(m_asusd->fanCurves(2).value(0).pwm, MockAsusd::defaultCurves(2).value(0).pwm);
+}
+
+void TestDBusClients::auraHotplug()
+{
+    auto client = connectedAsusd();
+    QVERIFY(client);
+    QTRY_COMPARE(client->auraDevices().size(), 1);
+
+    m_asusd->addAuraDevice("0b05_1866");
+    QTRY_COMPARE(client->auraDevices().size(), 2);
+
+    m_asusd->removeAuraDevice("0b05_1866");
+    QTRY_COMPARE(client->auraDevices().size(), 1);
+}
+
+void TestDBusClients::asusdExitAndReturn()
+{
+    auto client = connectedAsusd();
+    QVERIFY(client);
+    QTRY_COMPARE(client->auraDevices().size(), 1);
+    QSignalSpy connected(client.get(), &AsusdClient::connectedChanged);
+
+    // What main() does when DBusWatcher sees the name go
+    m_asusd->stop();
+    client->serviceLost();
+    QVERIFY(!client->isConnected());
+    QVERIFY(client->auraDevices().isEmpty());
+    QCOMPARE(connected.count(), 1);
+    QCOMPARE(connected.at(0).at(0).toBool(), false);
+
+    QVERIFY(m_asusd->start());
+    client->reconnect();
+    QTRY_VERIFY(client->isConnected());
+    QTRY_COMPARE(client->auraDevices().size(), 1);
+}
+
+void TestDBusClients::gpuModeSwitch()
+{
+    SuperGfxClient client;
+    QTRY_VERIFY(client.isConnected());
+    QTRY_COMPARE(client.supportedModes(), (QList<int>{0, 1, 2}));
+    QTRY_COMPARE(client.currentMode(), int(m_gfx->mode()));
+
+    client.setMode(SuperGfxClient::Integrated);
+    QTRY_COMPARE(client.currentMode(), int(SuperGfxClient::Integrated));
+    QCOMPARE(m_gfx->mode(), 0u);
+    QVERIFY(!client.switchPending());
+
+    m_gfx->setPower(2);
+    QTRY_COMPARE(client.gpuPower(), QString("Off"));
+
+    // Back to the default for the other tests
+    client.setMode(SuperGfxClient::Hybrid);
+    QTRY_COMPARE(m_gfx->mode(), 1u);
+}
+
+void TestDBusClients::gpuSwitchNeedingLogout()
+{
+    SuperGfxClient client;
+    QTRY_VERIFY(client.isConnected());
+
+    QSignalSpy logout(&client, &SuperGfxClient::logoutRequired);
+    client.setMode(SuperGfxClient::AsusMuxDgpu);
+    QTRY_COMPARE(logout.count(), 1);
+    QVERIFY(client.switchPending());
+    QCOMPARE(client.pendingMode(), int(SuperGfxClient::AsusMuxDgpu));
+
+    m_gfx->completeSwitch();
+    QTRY_VERIFY(!client.switchPending());
+    QCOMPARE(client.currentMode(), int(SuperGfxClient::AsusMuxDgpu));
+
+    client.setMode(SuperGfxClient::Hybrid);
+    QTRY_COMPARE(logout.count(), 2);
+    m_gfx->completeSwitch();
+    QTRY_COMPARE(client.currentMode(), int(SuperGfxClient::Hybrid));
+}
+
+void TestDBusClients::gpuDaemonRegistersLate()
+{
+    // No unit file found at startup, yet the daemon shows up later
+    m_gfx->stop();
+    const qint64 probes = LatencyStats::instance()->count(LatencyStats::NameHasOwner);
+    SuperGfxClient client;
+    client.setServiceInstalled(false);
+    QTRY_VERIFY(LatencyStats::instance()->count(LatencyStats::NameHasOwner) > probes);
+    QVERIFY(!client.isConnected());
+
+    // What main() does on supergfxConnectedChanged(true)
+    QVERIFY(m_gfx->start());
+    client.reconnect();
+    QTRY_VERIFY(client.isConnected());
+}
+
+void TestDBusClients::watcherFollowsNameOwner()
+{
+    DBusWatcher watcher;
+    QTRY_VERIFY(watcher.asusdConnected());
+    QTRY_VERIFY(watcher.supergfxConnected());
+    QVERIFY(watcher.allConnected());
+
+    m_asusd->stop();
+    QTRY_VERIFY(!watcher.asusdConnected());
+    QVERIFY(!watcher.allConnected());
+
+    QVERIFY(m_asusd->start());
+    QTRY_VERIFY(watcher.asusdConnected());
+}
+
+GHELPER_TEST(TestDBusClients);
+
+#include "TestDBusClients.moc"
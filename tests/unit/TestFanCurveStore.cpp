@@ -0,0 +1,81 @@
+#include "TestSuite.h"
+#include "FanCurveStore.h"
+#include "FanCurveFixtures.h"
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+#include <memory>
+
+class TestFanCurveStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void roundTrip();
+    void unchangedCurveIsNotWritten();
+    void rejectsInvalidFile();
+
+private:
+    std::unique_ptr<QTemporaryDir> m_dir;
+};
+
+void TestFanCurveStore::init()
+{
+    m_dir = std::make_unique<QTemporaryDir>();
+    QVERIFY(m_dir->isValid());
+}
+
+void TestFanCurveStore::roundTrip()
+{
+    const QString path = m_dir->filePath("fan-curves.bin");
+    {
+        FanCurveStore store(path);
+        store.setCurve(0, 0, FanCurveFixtures::points(0), true);
+        store.setCurve(2, 1, FanCurveFixtures::points(20), false);
+        QVERIFY(store.isDirty());
+        QVERIFY(store.flush());
+        QVERIFY(!store.isDirty());
+    }
+
+    FanCurveStore store(path);
+    QVERIFY(store.load());
+    QVERIFY(store.contains(0, 0));
+    QVERIFY(store.contains(2, 1));
+    QVERIFY(!store.contains(1, 0));
+    QCOMPARE(store.curve(0, 0), FanCurveFixtures::points(0));
+    QCOMPARE(store.curve(2, 1), FanCurveFixtures::points(20));
+    QVERIFY(store.isEnabled(0, 0));
+    QVERIFY(!store.isEnabled(2, 1));
+}
+
+void TestFanCurveStore::unchangedCurveIsNotWritten()
+{
+    FanCurveStore store(m_dir->filePath("fan-curves.bin"));
+    store.setCurve(1, 0, FanCurveFixtures::points(5), true);
+    QVERIFY(store.flush());
+    const qint64 written = store.totalBytesWritten();
+    QVERIFY(written > 0);
+
+    store.setCurve(1, 0, FanCurveFixtures::points(5), true);
+    QVERIFY(!store.isDirty());
+    QVERIFY(store.flush());
+    QCOMPARE(store.totalBytesWritten(), written);
+}
+
+void TestFanCurveStore::rejectsInvalidFile()
+{
+    const QString path = m_dir->filePath("fan-curves.bin");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("not a fan curve store");
+    file.close();
+
+    FanCurveStore store(path);
+    QVERIFY(!store.load());
+    QVERIFY(!store.contains(0, 0));
+}
+
+GHELPER_TEST(TestFanCurveStore);
+
+#include "TestFanCurveStore.moc"
@@ -0,0 +1,140 @@
+#include "TestSuite.h"
+#include "LatencyStats.h"
+#include <QTest>
+#include <limits>
+
+class TestLatencyStats : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void exactBelowSubBuckets();
+    void powerOfTwoStartsBucket_data();
+    void powerOfTwoStartsBucket();
+    void relativeErrorBound();
+    void largestValue();
+    void percentileWithoutSamples();
+    void percentileWithOneSample_data();
+    void percentileWithOneSample();
+    void percentileOfUniformSamples();
+
+private:
+    static constexpr LatencyStats::Operation OP = LatencyStats::SetChargeLimit;
+};
+
+void TestLatencyStats::init()
+{
+    LatencyStats::instance()->reset();
+}
+
+void TestLatencyStats::exactBelowSubBuckets()
+{
+    for (int usecs = 0; usecs < LatencyStats::SUB_BUCKETS; usecs++) {
+        QCOMPARE(LatencyStats::bucketIndex(usecs), usecs);
+        QCOMPARE(LatencyStats::bucketUpperBound(usecs), qint64(usecs));
+    }
+}
+
+void TestLatencyStats::powerOfTwoStartsBucket_data()
+{
+    QTest::addColumn<int>("exponent");
+    for (int exponent = LatencyStats::SUB_BUCKET_BITS; exponent < 63; exponent += 5) {
+        QTest::newRow(qPrintable(QString("2^%1").arg(exponent))) << exponent;
+    }
+    QTest::newRow("2^63") << 63;
+}
+
+void TestLatencyStats::powerOfTwoStartsBucket()
+{
+    // 2^e opens the first of the 8 sub-buckets of its power, each 2^(e-3) wide
+    QFETCH(int, exponent);
+    const quint64 value = quint64(1) << exponent;
+    const int index = LatencyStats::bucketIndex(value);
+
+    QCOMPARE(LatencyStats::bucketIndex(value - 1), index - 1);
+    QCOMPARE(quint64(LatencyStats::bucketUpperBound(index - 1)), value - 1);
+    QCOMPARE(quint64(LatencyStats::bucketUpperBound(index)),
+             value + (value >> LatencyStats::SUB_BUCKET_BITS) - 1);
+    QCOMPARE(index % LatencyStats::SUB_BUCKETS, 0);
+}
+
+void TestLatencyStats::relativeErrorBound()
+{
+    // The reported upper bound is never below the value, and at most 12.5% above it
+    for (quint64 usecs = 0; usecs < 20000000; usecs = usecs < 4096 ? usecs + 1 : usecs + usecs / 97) {
+        const int index = LatencyStats::bucketIndex(usecs);
+        QVERIFY(index >= 0 && index < LatencyStats::BUCKETS);
+        const quint64 upper = quint64(LatencyStats::bucketUpperBound(index));
+        QVERIFY2(upper >= usecs, qPrintable(QString::number(usecs)));
+        QVERIFY2((upper - usecs) * 8 <= usecs, qPrintable(QString::number(usecs)));
+        QVERIFY(index == 0 || quint64(LatencyStats::bucketUpperBound(index - 1)) < usecs);
+    }
+}
+
+void TestLatencyStats::largestValue()
+{
+    const quint64 largest = std::numeric_limits<quint64>::max();
+    QCOMPARE(LatencyStats::bucketIndex(largest), LatencyStats::BUCKETS - 1);
+}
+
+void TestLatencyStats::percentileWithoutSamples()
+{
+    auto *stats = LatencyStats::instance();
+    QCOMPARE(stats->count(OP), qint64(0));
+    QCOMPARE(stats->percentile(OP, 0), qint64(0));
+    QCOMPARE(stats->percentile(OP, 50), qint64(0));
+    QCOMPARE(stats->percentile(OP, 100), qint64(0));
+    QCOMPARE(stats->max(OP), qint64(0));
+}
+
+void TestLatencyStats::percentileWithOneSample_data()
+{
+    QTest::addColumn<qint64>("nsecs");
+    QTest::addColumn<qint64>("usecs");
+
+    QTest::newRow("below 1 us") << qint64(999) << qint64(0);
+    QTest::newRow("exact bucket") << qint64(5000) << qint64(5);
+    QTest::newRow("power of two") << qint64(1024000) << qint64(1024);
+    QTest::newRow("inside a bucket") << qint64(1000000) << qint64(1000);
+}
+
+void TestLatencyStats::percentileWithOneSample()
+{
+    // Every percentile is the sample itself: the bucket bound is capped at the maximum
+    QFETCH(qint64, nsecs);
+    QFETCH(qint64, usecs);
+
+    auto *stats = LatencyStats::instance();
+    stats->record(OP, nsecs);
+    QCOMPARE(stats->count(OP), qint64(1));
+    QCOMPARE(stats->max(OP), usecs);
+    for (double pct : {0.0, 50.0, 90.0, 99.0, 100.0}) {
+        QCOMPARE(stats->percentile(OP, pct), usecs);
+    }
+}
+
+void TestLatencyStats::percentileOfUniformSamples()
+{
+    // 1..1000 us once each: pN lands on the bucket holding N * 10
+    auto *stats = LatencyStats::instance();
+    for (qint64 usecs = 1; usecs <= 1000; usecs++) {
+        stats->record(OP, usecs * 1000, usecs % 100 == 0);
+    }
+    QCOMPARE(stats->count(OP), qint64(1000));
+    QCOMPARE(stats->errors(OP), qint64(10));
+    QCOMPARE(stats->max(OP), qint64(1000));
+
+    for (int pct : {10, 50, 90, 99}) {
+        const qint64 exact = pct * 10;
+        const qint64 reported = stats->percentile(OP, pct);
+        QVERIFY2(reported >= exact && (reported - exact) * 8 <= exact,
+                 qPrintable(QString("p%1 = %2").arg(pct).arg(reported)));
+    }
+    QCOMPARE(stats->percentile(OP, 100), qint64(1000));
+}
+
+GHELPER_TEST(TestLatencyStats);
+
+#include "TestLatencyStats.moc"
@@ -0,0 +1,106 @@
+#include "TestSuite.h"
+#include "PendingWriteTracker.h"
+#include <QTest>
+
+class TestPendingWriteTracker : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void echoConfirms();
+    void staleEchoIsSuppressed();
+    void lateEchoAfterAcknowledge();
+    void lateEchoAfterNewerAcknowledge();
+    void externalChange();
+    void failFallsBackOnlyWhenNothingInFlight();
+};
+
+void TestPendingWriteTracker::echoConfirms()
+{
+    PendingWriteTracker tracker;
+    tracker.begin("PlatformProfile", 2u);
+
+    QCOMPARE(tracker.reconcile("PlatformProfile", 2u), PendingWriteTracker::Apply);
+    QVERIFY(!tracker.isPending("PlatformProfile"));
+    QCOMPARE(tracker.confirmedCount(), 1);
+    QCOMPARE(tracker.externalCount(), 0);
+}
+
+void TestPendingWriteTracker::staleEchoIsSuppressed()
+{
+    PendingWriteTracker tracker;
+    tracker.begin("PlatformProfile", 0u);
+    tracker.begin("PlatformProfile", 2u);
+
+    // The first write's echo must not undo the second one
+    QCOMPARE(tracker.reconcile("PlatformProfile", 0u), PendingWriteTracker::Suppress);
+    QCOMPARE(tracker.reconcile("PlatformProfile", 2u), PendingWriteTracker::Apply);
+    QVERIFY(!tracker.isPending("PlatformProfile"));
+    QCOMPARE(tracker.externalCount(), 0);
+}
+
+void TestPendingWriteTracker::lateEchoAfterAcknowledge()
+{
+    PendingWriteTracker tracker;
+    const quint64 generation = tracker.begin("Brightness", 3u);
+
+    // Method reply first, PropertiesChanged afterwards
+    tracker.acknowledge("Brightness", generation);
+    QVERIFY(tracker.isPending("Brightness"));
+
+    QCOMPARE(tracker.reconcile("Brightness", 3u), PendingWriteTracker::Apply);
+    QVERIFY(!tracker.isPending("Brightness"));
+    QCOMPARE(tracker.confirmedCount(), 1);
+    QCOMPARE(tracker.externalCount(), 0);
+}
+
+void TestPendingWriteTracker::lateEchoAfterNewerAcknowledge()
+{
+    PendingWriteTracker tracker;
+    const quint64 first = tracker.begin("Brightness", 1u);
+    const quint64 second = tracker.begin("Brightness", 3u);
+
+    // Both replies arrive before either echo
+    tracker.acknowledge("Brightness", first);
+    tracker.acknowledge("Brightness", second);
+
+    // The older echo lands late: not an external change, no flicker back to 1
+    QCOMPARE(tracker.reconcile("Brightness", 1u), PendingWriteTracker::Suppress);
+    QCOMPARE(tracker.externalCount(), 0);
+
+    QCOMPARE(tracker.reconcile("Brightness", 3u), PendingWriteTracker::Apply);
+    QVERIFY(!tracker.isPending("Brightness"));
+    QCOMPARE(tracker.externalCount(), 0);
+}
+
+void TestPendingWriteTracker::externalChange()
+{
+    PendingWriteTracker tracker;
+    const quint64 generation = tracker.begin("PlatformProfile", 1u);
+    tracker.acknowledge("PlatformProfile", generation);
+
+    // Fn+F5 before our echo came back
+    QCOMPARE(tracker.reconcile("PlatformProfile", 2u), PendingWriteTracker::Apply);
+    QCOMPARE(tracker.externalCount(), 1);
+    QVERIFY(!tracker.isPending("PlatformProfile"));
+}
+
+void TestPendingWriteTracker::failFallsBackOnlyWhenNothingInFlight()
+{
+    PendingWriteTracker tracker;
+    const quint64 first = tracker.begin("ChargeControlEndThreshold", 80);
+    const quint64 second = tracker.begin("ChargeControlEndThreshold", 60);
+
+    // The first write is still in flight and may yet decide the value
+    QVERIFY(!tracker.fail("ChargeControlEndThreshold", second));
+
+    // Once it is acknowledged, a failure of the newest write falls back
+    const quint64 third = tracker.begin("ChargeControlEndThreshold", 70);
+    tracker.acknowledge("ChargeControlEndThreshold", first);
+    QVERIFY(tracker.fail("ChargeControlEndThreshold", third));
+    QCOMPARE(tracker.failedCount(), 2);
+}
+
+GHELPER_TEST(TestPendingWriteTracker);
+
+#include "TestPendingWriteTracker.moc"
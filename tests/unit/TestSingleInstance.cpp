@@ -0,0 +1,227 @@
+#include "TestSuite.h"
+#include "SingleInstance.h"
+#include "PrivateBus.h"
+#include "MockAsusd.h"
+#include "MockSuperGfx.h"
+#include "AsusdClient.h"
+#include "SuperGfxClient.h"
+#include "PerformanceController.h"
+#include "GpuController.h"
+#include "SystemMonitor.h"
+#include "RemoteControl.h"
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QTemporaryDir>
+#include <QTemporaryFile>
+#include <QTest>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// A second launch talking to the running instance over the socket in
+// $XDG_RUNTIME_DIR, pointed at a temporary directory for the test run.
+class TestSingleInstance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void forwardsArguments_data();
+    void forwardsArguments();
+    void noInstance();
+    void unresponsiveInstance();
+    void secondListenFails();
+    void remoteControlStatus();
+    void remoteControlChargeLimit();
+
+private:
+    // Runs SingleInstance::forward() on a worker thread while this thread
+    // serves the instance; what forward() prints ends up in *printed
+    static bool forward(const QStringList &arguments, QByteArray *printed);
+
+    // The handler the GUI and headless daemon install, against the mock daemons
+    struct Remote {
+        AsusdClient asusdClient;
+        SuperGfxClient superGfxClient;
+        PerformanceController performanceController{&asusdClient};
+        GpuController gpuController{&superGfxClient};
+        SystemMonitor systemMonitor;
+        RemoteControl remoteControl{&asusdClient, &performanceController, &gpuController, &systemMonitor};
+    };
+
+    QTemporaryDir m_runtimeDir;
+    QByteArray m_savedRuntimeDir;
+};
+
+void TestSingleInstance::initTestCase()
+{
+    QVERIFY(m_runtimeDir.isValid());
+    m_savedRuntimeDir = qgetenv("XDG_RUNTIME_DIR");
+    qputenv("XDG_RUNTIME_DIR", m_runtimeDir.path().toLocal8Bit());
+    QCOMPARE(SingleInstance::socketPath(), m_runtimeDir.filePath("g-helper-linux.sock"));
+}
+
+void TestSingleInstance::cleanupTestCase()
+{
+    qputenv("XDG_RUNTIME_DIR", m_savedRuntimeDir);
+}
+
+bool TestSingleInstance::forward(const QStringList &arguments, QByteArray *printed)
+{
+    std::vector<QByteArray> storage{"g-helper-linux"};
+    for (const QString &argument : arguments) {
+        storage.push_back(argument.toUtf8());
+    }
+    std::vector<char *> argv;
+    for (QByteArray &argument : storage) {
+        argv.push_back(argument.data());
+    }
+
+    QTemporaryFile output;
+    if (!output.open()) return false;
+    std::fflush(stdout);
+    const int savedStdout = ::dup(STDOUT_FILENO);
+    ::dup2(output.handle(), STDOUT_FILENO);
+
+    std::atomic<bool> done = false;
+    bool result = false;
+    std::thread client([&]() {
+        result = SingleInstance::forward(static_cast<int>(argv.size()), argv.data());
+        done = true;
+    });
+    QTest::qWaitFor([&done]() { return done.load(); }, 5000);
+    client.join();
+
+    std::fflush(stdout);
+    ::dup2(savedStdout, STDOUT_FILENO);
+    ::close(savedStdout);
+
+    output.seek(0);
+    *printed = output.readAll();
+    return result;
+}
+
+void TestSingleInstance::forwardsArguments_data()
+{
+    QTest::addColumn<QStringList>("arguments");
+    QTest::addColumn<QString>("reply");
+
+    QTest::newRow("options") << QStringList{"--profile", "quiet", "--charge-limit=80"} << "profile: quiet\n";
+    QTest::newRow("no arguments") << QStringList{} << "";
+    QTest::newRow("empty argument") << QStringList{"--profile", "", "--minimized"} << "ok\n";
+    QTest::newRow("utf-8") << QStringList{"--profile", "lärm"} << "unknown profile: lärm\n";
+}
+
+void TestSingleInstance::forwardsArguments()
+{
+    QFETCH(QStringList, arguments);
+    QFETCH(QString, reply);
+
+    SingleInstance instance;
+    QVERIFY(instance.listen());
+    QStringList received;
+    int calls = 0;
+    instance.setHandler([&](const QStringList &forwarded) {
+        received = forwarded;
+        calls++;
+        return reply;
+    });
+
+    QByteArray printed;
+    QVERIFY(forward(arguments, &printed));
+    QCOMPARE(calls, 1);
+    QCOMPARE(received, arguments);
+    QCOMPARE(QString::fromUtf8(printed), reply);
+}
+
+void TestSingleInstance::noInstance()
+{
+    QByteArray printed;
+    QVERIFY(!forward({"--status"}, &printed));
+    QVERIFY(printed.isEmpty());
+}
+
+void TestSingleInstance::unresponsiveInstance()
+{
+    // Accepts connections but never answers, like a wedged instance
+    QLocalServer server;
+    QVERIFY(server.listen(SingleInstance::socketPath()));
+
+    QElapsedTimer timer;
+    timer.start();
+    QByteArray printed;
+    QVERIFY(!forward({"--status"}, &printed));
+    QVERIFY(timer.elapsed() < 4 * SingleInstance::IO_TIMEOUT_MS);
+    QVERIFY(printed.isEmpty());
+}
+
+void TestSingleInstance::secondListenFails()
+{
+    SingleInstance first;
+    QVERIFY(first.listen());
+
+    SingleInstance second;
+    QVERIFY(!second.listen());
+}
+
+void TestSingleInstance::remoteControlStatus()
+{
+    if (!PrivateBus::isRunning()) {
+        QSKIP("dbus-daemon is not available");
+    }
+    MockAsusd asusd;
+    MockSuperGfx gfx;
+    QVERIFY(asusd.start());
+    QVERIFY(gfx.start());
+
+    Remote remote;
+    QTRY_VERIFY(remote.performanceController.isAvailable());
+    QTRY_VERIFY(remote.gpuController.isAvailable());
+    QTRY_COMPARE(remote.asusdClient.chargeLimit(), asusd.chargeLimit());
+
+    SingleInstance instance;
+    QVERIFY(instance.listen());
+    instance.setHandler([&remote](const QStringList &arguments) {
+        return remote.remoteControl.execute(arguments);
+    });
+
+    // What `g-helper-linux-headless --status` prints from a second launch
+    QByteArray printed;
+    QVERIFY(forward({"--status"}, &printed));
+    QCOMPARE(QString::fromUtf8(printed), remote.remoteControl.status());
+    QVERIFY(printed.contains("charge-limit: " + QByteArray::number(asusd.chargeLimit()) + "\n"));
+    QVERIFY(!printed.contains("unavailable"));
+}
+
+void TestSingleInstance::remoteControlChargeLimit()
+{
+    if (!PrivateBus::isRunning()) {
+        QSKIP("dbus-daemon is not available");
+    }
+    MockAsusd asusd;
+    QVERIFY(asusd.start());
+
+    Remote remote;
+    SingleInstance instance;
+    QVERIFY(instance.listen());
+    instance.setHandler([&remote](const QStringList &arguments) {
+        return remote.remoteControl.execute(arguments);
+    });
+
+    const quint8 limit = asusd.chargeLimit() == 70 ? 80 : 70;
+    QByteArray printed;
+    QVERIFY(forward({"--charge-limit", QString::number(limit)}, &printed));
+    QVERIFY(printed.isEmpty());
+    QTRY_COMPARE(asusd.chargeLimit(), limit);
+
+    QVERIFY(forward({"--charge-limit", "5"}, &printed));
+    QCOMPARE(printed, QByteArray("Charge limit must be between 20 and 100\n"));
+}
+
+GHELPER_TEST(TestSingleInstance);
+
+#include "TestSingleInstance.moc"
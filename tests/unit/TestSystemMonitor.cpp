@@ -0,0 +1,102 @@
+#include "TestSuite.h"
+#include "SystemMonitor.h"
+#include <QSignalSpy>
+#include <QTest>
+
+class TestSystemMonitor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseCpuTimes_data();
+    void parseCpuTimes();
+    void parseMemInfo();
+    void parseMemInfoWithoutAvailable();
+    void predictionHorizonFollowsInterval();
+};
+
+void TestSystemMonitor::parseCpuTimes_data()
+{
+    QTest::addColumn<QString>("line");
+    QTest::addColumn<bool>("ok");
+    QTest::addColumn<qint64>("total");
+    QTest::addColumn<qint64>("idle");
+
+    QTest::newRow("full") << "cpu  4705 150 1120 16250 520 30 45 0 0 0" << true
+                          << qint64(4705 + 150 + 1120 + 16250 + 520) << qint64(16250 + 520);
+    QTest::newRow("no iowait") << "cpu 10 0 5 85" << true << qint64(100) << qint64(85);
+    QTest::newRow("per-cpu line") << "cpu0 4705 150 1120 16250 520" << false << qint64(0) << qint64(0);
+    QTest::newRow("truncated") << "cpu  4705 150" << false << qint64(0) << qint64(0);
+    QTest::newRow("empty") << "" << false << qint64(0) << qint64(0);
+}
+
+void TestSystemMonitor::parseCpuTimes()
+{
+    QFETCH(QString, line);
+    QFETCH(bool, ok);
+    QFETCH(qint64, total);
+    QFETCH(qint64, idle);
+
+    qint64 totalTime = 0;
+    qint64 idleTime = 0;
+    QCOMPARE(SystemMonitor::parseCpuTimes(line, &totalTime, &idleTime), ok);
+    if (ok) {
+        QCOMPARE(totalTime, total);
+        QCOMPARE(idleTime, idle);
+    }
+}
+
+void TestSystemMonitor::parseMemInfo()
+{
+    const QByteArray data =
+        "MemTotal:       32594772 kB\n"
+        "MemFree:         1203948 kB\n"
+        "MemAvailable:   20421336 kB\n"
+        "Buffers:          512340 kB\n";
+
+    qint64 total = 0;
+    qint64 available = 0;
+    QVERIFY(SystemMonitor::parseMemInfo(data, &total, &available));
+    QCOMPARE(total, qint64(32594772));
+    QCOMPARE(available, qint64(20421336));
+}
+
+void TestSystemMonitor::parseMemInfoWithoutAvailable()
+{
+    // Kernels before 3.14 have no MemAvailable
+    qint64 total = 0;
+    qint64 available = 0;
+    QVERIFY(SystemMonitor::parseMemInfo("MemTotal: 1024 kB\nMemFree: 512 kB\n", &total, &available));
+    QCOMPARE(total, qint64(1024));
+    QCOMPARE(available, qint64(0));
+
+    QVERIFY(!SystemMonitor::parseMemInfo("garbage\n", &total, &available));
+}
+
+void TestSystemMonitor::predictionHorizonFollowsInterval()
+{
+    // The model scores at most ThermalModel::maxHorizon() samples ahead
+    SystemMonitor monitor;
+    QSignalSpy changed(&monitor, &SystemMonitor::predictionHorizonChanged);
+
+    monitor.setPredictionHorizon(60);
+    QCOMPARE(monitor.predictionHorizon(), 30);
+
+    monitor.setUpdateInterval(250);
+    QCOMPARE(monitor.predictionHorizon(), ThermalModel::maxHorizon() * 250 / 1000);
+    QCOMPARE(changed.count(), 2);
+    QCOMPARE(changed.last().at(0).toInt(), monitor.predictionHorizon());
+
+    monitor.setPredictionHorizon(30);
+    QCOMPARE(monitor.predictionHorizon(), ThermalModel::maxHorizon() * 250 / 1000);
+    QCOMPARE(changed.count(), 2);
+
+    monitor.setUpdateInterval(1000);
+    monitor.setPredictionHorizon(30);
+    QCOMPARE(monitor.predictionHorizon(), 30);
+    QCOMPARE(changed.count(), 3);
+}
+
+GHELPER_TEST(TestSystemMonitor);
+
+#include "TestSystemMonitor.moc"